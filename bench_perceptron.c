@@ -0,0 +1,503 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#define NOB_IMPLEMENTATION
+#include "nob.h"
+#include "perceptron.h"
+#include "quant.h"
+#include "pool.h"
+#include "hogwild.h"
+#include "sparse.h"
+#include "kernel.h"
+
+// Headless benchmarks for the perceptron: ./bench_perceptron [section]
+
+#define SEEDS 5
+
+double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Linearly separable points in [0,1]^dim, labelled by a random hyperplane
+// through the centre, with a small margin kept empty.
+void add_blobs_dataset(Datasets *out, const char *name, int count, int dim, unsigned seed) {
+    srand(seed);
+    float *plane = malloc(sizeof(float) * dim);
+    for (int j = 0; j < dim; j++) plane[j] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+
+    DatasetInfo ds = {0};
+    if (!alloc_dataset(&ds, name, count, dim)) return;
+    for (int i = 0; i < count; ) {
+        float *row = dataset_row(&ds, i);
+        float s = 0;
+        for (int j = 0; j < dim; j++) {
+            row[j] = (float)rand() / RAND_MAX;
+            s += plane[j] * (row[j] - 0.5f);
+        }
+        if (fabsf(s) < 0.05f) continue;
+        row[dim] = s > 0 ? 1.0f : 0.0f;
+        i++;
+    }
+    compute_dataset_bounds(&ds);
+    da_append(out, ds);
+    free(plane);
+}
+
+// ── Optimizer convergence ───────────────────────────────────
+
+typedef struct {
+    const char *name;
+    Optimizer opt;
+} OptConfig;
+
+void bench_optimizers(const Datasets *sets, float target_mse) {
+    OptConfig configs[6];
+    int num_configs = 0;
+    configs[num_configs++] = (OptConfig){"SGD",            optimizer_default(OPT_SGD)};
+    configs[num_configs++] = (OptConfig){"Momentum",       optimizer_default(OPT_MOMENTUM)};
+    configs[num_configs++] = (OptConfig){"Nesterov",       optimizer_default(OPT_NESTEROV)};
+    configs[num_configs++] = (OptConfig){"Adam",           optimizer_default(OPT_ADAM)};
+    configs[num_configs] = (OptConfig){"SGD+step",         optimizer_default(OPT_SGD)};
+    configs[num_configs].opt.lr = 0.5f;
+    configs[num_configs++].opt.schedule = LR_STEP;
+    configs[num_configs] = (OptConfig){"Adam+cosine",      optimizer_default(OPT_ADAM)};
+    configs[num_configs++].opt.schedule = LR_COSINE;
+
+    printf("== optimizers: epochs and time to MSE < %g (mean over %d seeds) ==\n",
+           target_mse, SEEDS);
+    printf("%-10s %-12s %9s %12s %12s\n", "dataset", "optimizer", "converged", "epochs", "time ms");
+
+    for (size_t d = 0; d < sets->count; d++) {
+        const DatasetInfo *ds = &sets->items[d];
+        // Same total sample budget for every dataset
+        long long max_epochs = 4000000LL / (ds->count > 0 ? ds->count : 1);
+        if (max_epochs > 100000) max_epochs = 100000;
+
+        for (int c = 0; c < num_configs; c++) {
+            int converged = 0;
+            double sum_epochs = 0, sum_ms = 0;
+            for (int seed = 1; seed <= SEEDS; seed++) {
+                srand(seed);
+                Perceptron p = {0};
+                init_perceptron(&p, ds->dim);
+                float mse = 1.0f;
+                double t0 = now_ms();
+                long long e = 0;
+                while (e < max_epochs) {
+                    train_step(&p, &configs[c].opt, ds, &mse);
+                    e++;
+                    if (mse < target_mse) break;
+                }
+                double ms = now_ms() - t0;
+                if (mse < target_mse) {
+                    converged++;
+                    sum_epochs += e;
+                    sum_ms += ms;
+                }
+                free(p.w);
+            }
+            if (converged) {
+                printf("%-10s %-12s %6d/%-2d %12.0f %12.3f\n", ds->name, configs[c].name,
+                       converged, SEEDS, sum_epochs / converged, sum_ms / converged);
+            } else {
+                printf("%-10s %-12s %6d/%-2d %12s %12s\n", ds->name, configs[c].name,
+                       converged, SEEDS, "-", "-");
+            }
+        }
+    }
+    printf("\n");
+}
+
+// ── Quantized inference ─────────────────────────────────────
+
+void train_until(Perceptron *p, const DatasetInfo *ds, float target_mse, int max_epochs) {
+    Optimizer opt = optimizer_default(OPT_ADAM);
+    float mse = 1.0f;
+    for (int e = 0; e < max_epochs && mse >= target_mse; e++)
+        train_step(p, &opt, ds, &mse);
+}
+
+void bench_quant(const Datasets *sets) {
+    printf("== int8 inference: parity with float predict() ==\n");
+    printf("%-10s %12s %12s %12s\n", "dataset", "max |diff|", "mean |diff|", "agreement");
+
+    for (size_t d = 0; d < sets->count; d++) {
+        const DatasetInfo *ds = &sets->items[d];
+        srand(1);
+        Perceptron p = {0};
+        init_perceptron(&p, ds->dim);
+        train_until(&p, ds, 0.01f, 20000);
+
+        QPerceptron q = {0};
+        quantize_perceptron(&p, ds, &q);
+        QBatch batch = {0};
+        quantize_batch(&q, ds, 0, ds->count, &batch);
+        int16_t *out = malloc(sizeof(int16_t) * ds->count);
+        predict_q8_batch(&q, &batch, out);
+
+        double max_diff = 0, sum_diff = 0;
+        int agree = 0;
+        for (int i = 0; i < ds->count; i++) {
+            float f = predict(&p, dataset_row(ds, i));
+            float qf = (float)out[i] / Q8_ONE;
+            double diff = fabs(f - qf);
+            if (diff > max_diff) max_diff = diff;
+            sum_diff += diff;
+            if ((f > 0.5f) == (qf > 0.5f)) agree++;
+        }
+        printf("%-10s %12.5f %12.5f %11.2f%%\n", ds->name, max_diff,
+               sum_diff / ds->count, 100.0 * agree / ds->count);
+
+        free(out);
+        free_qbatch(&batch);
+        free_qperceptron(&q);
+        free(p.w);
+    }
+
+    // Throughput on a large batch
+    Datasets big = {0};
+    int rows = 1000000, dim = 8;
+    add_blobs_dataset(&big, "blobs-1M", rows, dim, 7);
+    const DatasetInfo *ds = &big.items[0];
+    srand(1);
+    Perceptron p = {0};
+    init_perceptron(&p, dim);
+    train_until(&p, ds, 0.01f, 3);
+
+    double t0 = now_ms();
+    volatile float sink = 0;
+    for (int i = 0; i < rows; i++) sink += predict(&p, dataset_row(ds, i));
+    double float_ms = now_ms() - t0;
+
+    QPerceptron q = {0};
+    quantize_perceptron(&p, ds, &q);
+    QBatch batch = {0};
+    t0 = now_ms();
+    quantize_batch(&q, ds, 0, rows, &batch);
+    double quant_ms = now_ms() - t0;
+
+    int16_t *out = malloc(sizeof(int16_t) * rows);
+    t0 = now_ms();
+    predict_q8_batch(&q, &batch, out);
+    double q8_ms = now_ms() - t0;
+    (void)sink;
+
+    printf("\n%d rows x %d inputs:\n", rows, dim);
+    printf("  float predict()    %8.2f ms  %8.1f Mrows/s\n", float_ms, rows / float_ms / 1e3);
+    printf("  int8 batch         %8.2f ms  %8.1f Mrows/s  (%.1fx)\n", q8_ms,
+           rows / q8_ms / 1e3, float_ms / q8_ms);
+    printf("  input quantization %8.2f ms (once per batch)\n\n", quant_ms);
+
+    free(out);
+    free_qbatch(&batch);
+    free_qperceptron(&q);
+    free(p.w);
+    free(big.items[0].data);
+    da_free(big);
+}
+
+// ── Batch scoring ───────────────────────────────────────────
+
+void bench_batch(void) {
+    printf("== predict_batch() vs predict() ==\n");
+    printf("%-8s %10s %12s %12s %9s %12s\n", "inputs", "rows", "predict ms", "batch ms",
+           "speedup", "max |diff|");
+
+    int dims[] = {2, 8, 16};
+    for (int d = 0; d < 3; d++) {
+        Datasets big = {0};
+        int rows = 1000000, dim = dims[d];
+        add_blobs_dataset(&big, "blobs", rows, dim, 5);
+        const DatasetInfo *ds = &big.items[0];
+        srand(1);
+        Perceptron p = {0};
+        init_perceptron(&p, dim);
+        train_until(&p, ds, 0.01f, 3);
+
+        float *ref = malloc(sizeof(float) * rows);
+        float *out = malloc(sizeof(float) * rows);
+        // Warm the pages so neither timing pays for first touch
+        predict_batch(&p, ds->data, ds->stride, rows, out);
+        memset(ref, 0, sizeof(float) * rows);
+
+        double t0 = now_ms();
+        for (int i = 0; i < rows; i++) ref[i] = predict(&p, dataset_row(ds, i));
+        double scalar_ms = now_ms() - t0;
+        t0 = now_ms();
+        predict_batch(&p, ds->data, ds->stride, rows, out);
+        double batch_ms = now_ms() - t0;
+
+        double max_diff = 0;
+        for (int i = 0; i < rows; i++) {
+            double diff = fabs(ref[i] - out[i]);
+            if (diff > max_diff) max_diff = diff;
+        }
+        printf("%-8d %10d %12.2f %12.2f %8.2fx %12.2e\n", dim, rows, scalar_ms, batch_ms,
+               scalar_ms / batch_ms, max_diff);
+
+        free(ref);
+        free(out);
+        free(p.w);
+        free(big.items[0].data);
+        da_free(big);
+    }
+    printf("\n");
+}
+
+// ── Sparse inputs ───────────────────────────────────────────
+
+// Two-topic synthetic corpus: words from a shared vocabulary plus a few
+// topic words, hashed into a dim-wide space.
+void add_topic_docs(SparseDataset *ds, int docs, unsigned seed) {
+    srand(seed);
+    char text[4096];
+    for (int d = 0; d < docs; d++) {
+        int topic = rand() % 2;
+        int words = 20 + rand() % 40;
+        size_t len = 0;
+        for (int k = 0; k < words && len < sizeof(text) - 32; k++) {
+            int shared = rand() % 50000;
+            if (rand() % 25 == 0)
+                len += snprintf(text + len, sizeof(text) - len, "t%d_%d ", topic, rand() % 500);
+            else
+                len += snprintf(text + len, sizeof(text) - len, "w%d ", shared);
+        }
+        sparse_add_text(ds, text, (float)topic);
+    }
+}
+
+float sparse_accuracy(const Perceptron *p, const SparseDataset *ds) {
+    int correct = 0;
+    for (int i = 0; i < ds->count; i++)
+        correct += (predict_sparse(p, ds, i) > 0.5f) == (ds->label.items[i] > 0.5f);
+    return ds->count ? (float)correct / ds->count : 0.0f;
+}
+
+#define SPARSE_EPOCHS 5
+#define DENSE_MAX_DIM (1 << 13)
+
+void bench_sparse(void) {
+    int train_docs = 4000, test_docs = 1000;
+    printf("== sparse vs dense: %d hashed docs, %d epochs SGD ==\n", train_docs, SPARSE_EPOCHS);
+    printf("%-9s %8s %14s %14s %10s\n", "dim", "nnz/row", "sparse us/row", "dense us/row", "test acc");
+
+    for (int bits = 10; bits <= 20; bits += 2) {
+        int dim = 1 << bits;
+        SparseDataset train, test;
+        sparse_init(&train, "train", dim);
+        sparse_init(&test, "test", dim);
+        add_topic_docs(&train, train_docs, 1);
+        add_topic_docs(&test, test_docs, 2);
+
+        Optimizer opt = optimizer_default(OPT_SGD);
+        opt.lr = 0.5f;
+        Perceptron p = {0};
+        init_perceptron_sparse(&p, dim);
+        float mse;
+        double t0 = now_ms();
+        for (int e = 0; e < SPARSE_EPOCHS; e++) train_step_sparse(&p, &opt, &train, &mse);
+        double sparse_us = (now_ms() - t0) * 1e3 / ((double)SPARSE_EPOCHS * train_docs);
+        float acc = sparse_accuracy(&p, &test);
+        free(p.w);
+
+        char dense_buf[32] = "-";
+        if (dim <= DENSE_MAX_DIM) {
+            DatasetInfo dense = {0};
+            if (sparse_to_dense(&train, &dense)) {
+                Perceptron q = {0};
+                init_perceptron_sparse(&q, dim);
+                t0 = now_ms();
+                for (int e = 0; e < SPARSE_EPOCHS; e++) train_step(&q, &opt, &dense, &mse);
+                double dense_us = (now_ms() - t0) * 1e3 / ((double)SPARSE_EPOCHS * train_docs);
+                snprintf(dense_buf, sizeof(dense_buf), "%.2f", dense_us);
+                free(q.w);
+                free(dense.data);
+            }
+        }
+        printf("%-9d %8.1f %14.3f %14s %9.1f%%\n", dim, (double)sparse_nnz(&train) / train.count,
+               sparse_us, dense_buf, acc * 100.0f);
+        sparse_free(&train);
+        sparse_free(&test);
+    }
+    printf("\n");
+}
+
+// ── Budgeted kernel perceptron ──────────────────────────────
+
+// nonld.c's concentric circles: inner disc r < 2 (+1), outer ring 3..5
+// (-1), with a fraction of labels flipped.
+void make_circles(float *X, int *y, int n, float noise, unsigned seed) {
+    srand(seed);
+    for (int i = 0; i < n; i++) {
+        bool inner = rand() % 2;
+        float angle = (float)rand() / RAND_MAX * 6.2831853f;
+        float r = inner ? (float)rand() / RAND_MAX * 2.0f : 3.0f + (float)rand() / RAND_MAX * 2.0f;
+        X[2 * i] = r * cosf(angle);
+        X[2 * i + 1] = r * sinf(angle);
+        y[i] = inner ? 1 : -1;
+        if ((float)rand() / RAND_MAX < noise) y[i] = -y[i];
+    }
+}
+
+float kperc_accuracy(KernelPerceptron *kp, const float *X, const int *y, int n) {
+    int correct = 0;
+    for (int i = 0; i < n; i++)
+        correct += (kperc_decision(kp, X + 2 * i) > 0) == (y[i] > 0);
+    return (float)correct / n;
+}
+
+void bench_kernel(void) {
+    int stream = 100000, test = 10000;
+    float *X = malloc(sizeof(float) * 2 * stream);
+    int *y = malloc(sizeof(int) * stream);
+    float *TX = malloc(sizeof(float) * 2 * test);
+    int *ty = malloc(sizeof(int) * test);
+    make_circles(X, y, stream, 0.05f, 1);
+    make_circles(TX, ty, test, 0.0f, 2);
+    Kernel rbf = {.kind = KERNEL_RBF, .gamma = 0.5f};
+
+    printf("== kernel perceptron: one pass over a %d-sample circle stream, 5%% label noise ==\n",
+           stream);
+    printf("%-9s %-9s %8s %6s %14s %9s\n", "budget", "policy", "seen", "SVs", "predict us", "test acc");
+
+    int budgets[] = {32, 128, 100000};
+    for (int b = 0; b < 3; b++) {
+        for (int policy = 0; policy < BUDGET_POLICY_COUNT; policy++) {
+            if (budgets[b] == stream && policy > 0) break;
+            KernelPerceptron kp;
+            kperc_init(&kp, rbf, 2, budgets[b], policy);
+            int seen = 0;
+            for (int checkpoint = 1000; checkpoint <= stream; checkpoint *= 10) {
+                for (; seen < checkpoint; seen++)
+                    kperc_train_sample(&kp, X + 2 * seen, y[seen], -1, NULL);
+                double t0 = now_ms();
+                float acc = kperc_accuracy(&kp, TX, ty, test);
+                double us = (now_ms() - t0) * 1e3 / test;
+                char bbuf[16];
+                snprintf(bbuf, sizeof(bbuf), budgets[b] == stream ? "none" : "%d", budgets[b]);
+                printf("%-9s %-9s %8d %6d %14.3f %8.1f%%\n", bbuf, BUDGET_POLICY_NAMES[policy],
+                       seen, kp.count, us, acc * 100.0f);
+            }
+            kperc_free(&kp);
+        }
+    }
+
+    // Repeated epochs over nonld.c's 256 points, with and without the cache
+    int n = 256, epochs = 50;
+    make_circles(X, y, n, 0.0f, 3);
+    printf("\n%d epochs over %d circle points, budget 64:\n", epochs, n);
+    for (int cached = 0; cached < 2; cached++) {
+        KernelPerceptron kp;
+        kperc_init(&kp, rbf, 2, 64, BUDGET_SMALLEST);
+        KernelCache cache;
+        kcache_init(&cache, n, &kp);
+        int last = 0;
+        double t0 = now_ms();
+        for (int e = 0; e < epochs; e++)
+            last = kperc_train_epoch(&kp, X, y, n, cached ? &cache : NULL);
+        double ms = now_ms() - t0;
+        printf("  %-9s %8.3f ms  last epoch mistakes %d", cached ? "cached" : "uncached", ms, last);
+        if (cached)
+            printf("  hit rate %.1f%%", 100.0 * cache.hits / (cache.hits + cache.misses));
+        printf("\n");
+        kcache_free(&cache);
+        kperc_free(&kp);
+    }
+    printf("\n");
+
+    free(X);
+    free(y);
+    free(TX);
+    free(ty);
+}
+
+// ── Parallel SGD ────────────────────────────────────────────
+
+#define PAR_EPOCHS 3
+
+void bench_hogwild(void) {
+    Datasets big = {0};
+    int rows = 1000000, dim = 16;
+    add_blobs_dataset(&big, "blobs-1M", rows, dim, 11);
+    const DatasetInfo *ds = &big.items[0];
+    Optimizer opt = optimizer_default(OPT_SGD);
+    opt.lr = 0.01f;
+
+    printf("== parallel SGD: %d rows x %d inputs, %d epochs, %d cores ==\n",
+           rows, dim, PAR_EPOCHS, pool_default_threads());
+    printf("%-9s %7s %12s %9s %10s\n", "mode", "threads", "ms/epoch", "speedup", "final MSE");
+
+    double serial_ms = 0;
+    int max_threads = pool_default_threads() * 2;
+    if (max_threads < 8) max_threads = 8;
+
+    for (int mode = PAR_SERIAL; mode < PAR_MODE_COUNT; mode++) {
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            if (mode == PAR_SERIAL && threads > 1) break;
+            ThreadPool pool;
+            pool_init(&pool, threads);
+            srand(3);
+            Perceptron p = {0};
+            init_perceptron(&p, dim);
+            float mse;
+            double t0 = now_ms();
+            for (int e = 0; e < PAR_EPOCHS; e++)
+                train_step_parallel(&p, &opt, ds, &pool, mode, &mse);
+            double ms = (now_ms() - t0) / PAR_EPOCHS;
+            if (mode == PAR_SERIAL) serial_ms = ms;
+            printf("%-9s %7d %12.2f %8.2fx %10.5f\n", PARALLEL_MODE_NAMES[mode], threads,
+                   ms, serial_ms / ms, evaluate_mse(&p, ds));
+            free(p.w);
+            pool_free(&pool);
+        }
+    }
+
+    // The averaged mode must depend on neither scheduling nor the thread count
+    float w_run[2][16];
+    for (int run = 0; run < 2; run++) {
+        ThreadPool pool;
+        pool_init(&pool, run ? 4 : 1);
+        srand(3);
+        Perceptron p = {0};
+        init_perceptron(&p, dim);
+        float mse;
+        for (int e = 0; e < PAR_EPOCHS; e++)
+            train_step_parallel(&p, &opt, ds, &pool, PAR_AVERAGE, &mse);
+        memcpy(w_run[run], p.w, sizeof(float) * dim);
+        free(p.w);
+        pool_free(&pool);
+    }
+    printf("averaged mode identical on 1 and 4 threads: %s\n\n",
+           memcmp(w_run[0], w_run[1], sizeof(w_run[0])) == 0 ? "yes" : "NO");
+
+    free(big.items[0].data);
+    da_free(big);
+}
+
+int main(int argc, char **argv) {
+    const char *section = argc > 1 ? argv[1] : "all";
+
+    Datasets sets = {0};
+    add_gate_datasets(&sets);
+    add_blobs_dataset(&sets, "blobs-8D", 10000, 8, 42);
+
+    if (strcmp(section, "all") == 0 || strcmp(section, "optimizers") == 0)
+        bench_optimizers(&sets, 0.01f);
+    if (strcmp(section, "all") == 0 || strcmp(section, "quant") == 0)
+        bench_quant(&sets);
+    if (strcmp(section, "all") == 0 || strcmp(section, "batch") == 0)
+        bench_batch();
+    if (strcmp(section, "all") == 0 || strcmp(section, "sparse") == 0)
+        bench_sparse();
+    if (strcmp(section, "all") == 0 || strcmp(section, "kernel") == 0)
+        bench_kernel();
+    if (strcmp(section, "all") == 0 || strcmp(section, "hogwild") == 0)
+        bench_hogwild();
+
+    return 0;
+}
@@ -0,0 +1,829 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "kernel.h"
+#include "smo.h"
+#include "dcd.h"
+#include "pool.h"
+#include "multiclass.h"
+#include "vmath.h"
+#include "pegasos.h"
+#include "rff.h"
+#include "nystrom.h"
+#include "svmodel.h"
+#include "incremental.h"
+
+// Headless benchmarks for the SVM solvers: ./bench_svm [section]
+
+double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+float randn(void) {
+    float u = ((float)rand() + 1.0f) / ((float)RAND_MAX + 2.0f);
+    float v = (float)rand() / RAND_MAX;
+    return sqrtf(-2.0f * logf(u)) * cosf(6.2831853f * v);
+}
+
+// Two unit Gaussians at +-sep/2 along the diagonal, labels +1 / -1, so the
+// classes overlap and the soft margin matters.
+void make_blobs(float *X, int *y, int n, int dim, float sep, unsigned seed) {
+    srand(seed);
+    float shift = sep / 2 / sqrtf((float)dim);
+    for (int i = 0; i < n; i++) {
+        y[i] = i % 2 ? 1 : -1;
+        for (int d = 0; d < dim; d++)
+            X[(size_t)i * dim + d] = randn() + y[i] * shift;
+    }
+}
+
+// 1/2 |w|^2 + C sum max(0, 1 - y (w.x + b))
+double linear_primal(const float *X, const int *y, int n, int dim, const float *w, float b,
+                     double C) {
+    double reg = 0, hinge = 0;
+    for (int d = 0; d < dim; d++) reg += 0.5 * w[d] * w[d];
+    for (int i = 0; i < n; i++) {
+        double f = b;
+        for (int d = 0; d < dim; d++) f += w[d] * X[(size_t)i * dim + d];
+        double h = 1.0 - y[i] * f;
+        if (h > 0) hinge += h;
+    }
+    return reg + C * hinge;
+}
+
+// svm.c's train() rule, with the regularizer scaled to the same C:
+// lambda = 1 / (n C) (train() itself is lambda = 1, i.e. C = 1/n).
+void sgd_epoch(const float *X, const int *y, int n, int dim, float *w, float *b, float lr,
+               float lambda) {
+    for (int i = 0; i < n; i++) {
+        const float *x = X + (size_t)i * dim;
+        float f = *b;
+        for (int d = 0; d < dim; d++) f += w[d] * x[d];
+        if (y[i] * f >= 1) {
+            for (int d = 0; d < dim; d++) w[d] -= lr * lambda * w[d];
+        } else {
+            for (int d = 0; d < dim; d++) w[d] -= lr * (lambda * w[d] - y[i] * x[d]);
+            *b += lr * y[i];
+        }
+    }
+}
+
+// ── SMO ─────────────────────────────────────────────────────
+
+#define SGD_BUDGET_MS 5000.0
+
+void bench_smo(void) {
+    double C = 1.0;
+    int dim = 2;
+    printf("== SMO (linear, C = %g, eps = 1e-3) vs per-epoch SGD to within 0.1%% of the optimum ==\n", C);
+    printf("%8s %10s %10s %8s %8s %12s %10s %14s\n", "n", "iters", "SMO ms", "SVs", "at C",
+           "primal", "rel gap", "SGD ms");
+
+    for (int n = 1000; n <= 100000; n *= 10) {
+        float *X = malloc(sizeof(float) * n * dim);
+        int *y = malloc(sizeof(int) * n);
+        make_blobs(X, y, n, dim, 4.0f, 7);
+
+        SmoSolver s;
+        Kernel linear = {.kind = KERNEL_LINEAR};
+        double t0 = now_ms();
+        smo_init(&s, X, y, n, dim, linear, C);
+        smo_run(&s, 0);
+        double smo_ms = now_ms() - t0;
+
+        float w[2];
+        smo_linear_weights(&s, w);
+        double primal = linear_primal(X, y, n, dim, w, (float)s.b, C);
+        double dual = -smo_dual_objective(&s);
+        int bounded;
+        int sv = smo_support_count(&s, &bounded);
+
+        // SGD with svm.c's step size until it gets within 0.1% or runs out of time
+        float sw[2] = {0}, sb = 0;
+        double sgd_ms = 0;
+        bool reached = false;
+        t0 = now_ms();
+        while (sgd_ms < SGD_BUDGET_MS) {
+            sgd_epoch(X, y, n, dim, sw, &sb, 1e-4f, (float)(1.0 / (n * C)));
+            sgd_ms = now_ms() - t0;
+            if (linear_primal(X, y, n, dim, sw, sb, C) <= primal * 1.001) {
+                reached = true;
+                break;
+            }
+        }
+        char sgd_buf[32];
+        if (reached) snprintf(sgd_buf, sizeof(sgd_buf), "%.1f", sgd_ms);
+        else snprintf(sgd_buf, sizeof(sgd_buf), "> %.0f", SGD_BUDGET_MS);
+
+        printf("%8d %10lld %10.1f %8d %8d %12.3f %10.1e %14s\n", n, s.iter, smo_ms, sv, bounded,
+               primal, (primal - dual) / fabs(primal), sgd_buf);
+        smo_free(&s);
+        free(X);
+        free(y);
+    }
+    printf("\n");
+}
+
+// ── Kernel SVM and the row cache ────────────────────────────
+
+// nonld.c's concentric circles: inner disc r < 2 (+1), outer ring 3..5
+// (-1), with a fraction of labels flipped.
+void make_circles(float *X, int *y, int n, float noise, unsigned seed) {
+    srand(seed);
+    for (int i = 0; i < n; i++) {
+        bool inner = rand() % 2;
+        float angle = (float)rand() / RAND_MAX * 6.2831853f;
+        float r = inner ? (float)rand() / RAND_MAX * 2.0f : 3.0f + (float)rand() / RAND_MAX * 2.0f;
+        X[2 * i] = r * cosf(angle);
+        X[2 * i + 1] = r * sinf(angle);
+        y[i] = inner ? 1 : -1;
+        if ((float)rand() / RAND_MAX < noise) y[i] = -y[i];
+    }
+}
+
+typedef struct {
+    const char *data;
+    int n;
+    int dim;
+    Kernel kernel;
+} KernelCase;
+
+void bench_kernel(void) {
+    KernelCase cases[] = {
+        {"circles", 10000, 2, {.kind = KERNEL_RBF, .gamma = 0.5f}},
+        {"circles", 10000, 2, {.kind = KERNEL_POLY, .gamma = 0.25f, .coef0 = 1.0f, .degree = 2}},
+        {"circles", 40000, 2, {.kind = KERNEL_RBF, .gamma = 0.5f}},
+        {"blobs32", 10000, 32, {.kind = KERNEL_RBF, .gamma = 1.0f / 32}},
+        {"blobs32", 40000, 32, {.kind = KERNEL_RBF, .gamma = 1.0f / 32}},
+    };
+    size_t budgets[] = {0, 8u << 20, 256u << 20};
+    double C = 1.0;
+
+    printf("== kernel SVM (SMO, C = %g): kernel row cache budget ==\n", C);
+    printf("%-8s %-6s %6s %9s %6s %8s %9s %9s %10s %9s\n", "data", "kernel", "n", "cache MB",
+           "rows", "iters", "computed", "hit rate", "ms", "train acc");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        KernelCase kc = cases[c];
+        float *X = malloc(sizeof(float) * kc.n * kc.dim);
+        int *y = malloc(sizeof(int) * kc.n);
+        if (kc.dim == 2) make_circles(X, y, kc.n, 0.05f, 11);
+        else make_blobs(X, y, kc.n, kc.dim, 3.0f, 11);
+
+        for (size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++) {
+            SmoSolver s;
+            double t0 = now_ms();
+            smo_init(&s, X, y, kc.n, kc.dim, kc.kernel, C);
+            smo_set_cache_bytes(&s, budgets[b]);
+            smo_run(&s, 0);
+            double ms = now_ms() - t0;
+
+            int correct = 0, checked = 0;
+            for (int i = 0; i < kc.n; i += 10, checked++)
+                correct += (smo_decision(&s, X + (size_t)i * kc.dim) > 0) == (y[i] > 0);
+            long long lookups = s.cache_hits + s.rows_computed;
+            printf("%-8s %-6s %6d %9.0f %6d %8lld %9lld %8.1f%% %10.1f %8.1f%%\n", kc.data,
+                   KERNEL_NAMES[kc.kernel.kind], kc.n, budgets[b] / 1048576.0, s.cache_rows,
+                   s.iter, s.rows_computed, 100.0 * s.cache_hits / lookups, ms,
+                   100.0 * correct / checked);
+            smo_free(&s);
+        }
+        free(X);
+        free(y);
+    }
+    printf("\n");
+}
+
+// ── Dual coordinate descent ─────────────────────────────────
+
+void bench_dcd(void) {
+    double C = 1.0;
+    int dims[] = {2, 32};
+    printf("== dual coordinate descent (C = %g, eps = 0.1) vs per-epoch SGD ==\n", C);
+    printf("SGD target: within 0.1%% of DCD's L1 objective, svm.c's step size, %.0f ms budget\n",
+           SGD_BUDGET_MS);
+    printf("%4s %7s %-4s %7s %12s %10s %10s %12s %18s\n", "dim", "n", "loss", "passes",
+           "visits / n", "updates", "ms", "objective", "SGD ms (epochs)");
+
+    for (int di = 0; di < 2; di++) {
+        int dim = dims[di];
+        for (int n = 1000; n <= 100000; n *= 10) {
+            float *X = malloc(sizeof(float) * n * dim);
+            int *y = malloc(sizeof(int) * n);
+            make_blobs(X, y, n, dim, 4.0f, 7);
+
+            double l1_obj = 0;
+            for (int loss = 0; loss < DCD_LOSS_COUNT; loss++) {
+                DcdSvm s;
+                dcd_init(&s, n, dim, loss, C);
+                double t0 = now_ms();
+                dcd_train(&s, X, y);
+                double ms = now_ms() - t0;
+                double obj = dcd_primal(&s, X, y);
+
+                // The train() loop has an unregularized bias, so both are
+                // scored on linear_primal()
+                char sgd_buf[32] = "";
+                if (loss == DCD_L1_LOSS) {
+                    l1_obj = linear_primal(X, y, n, dim, s.w, s.w[dim], C);
+                    float *sw = calloc(dim, sizeof(float)), sb = 0;
+                    double sgd_ms = 0;
+                    int epochs = 0;
+                    bool reached = false;
+                    t0 = now_ms();
+                    while (sgd_ms < SGD_BUDGET_MS) {
+                        sgd_epoch(X, y, n, dim, sw, &sb, 1e-4f, (float)(1.0 / (n * C)));
+                        epochs++;
+                        sgd_ms = now_ms() - t0;
+                        if (linear_primal(X, y, n, dim, sw, sb, C) <= l1_obj * 1.001) {
+                            reached = true;
+                            break;
+                        }
+                    }
+                    snprintf(sgd_buf, sizeof(sgd_buf), reached ? "%.1f (%d ep)" : "> %.0f (%d ep)",
+                             reached ? sgd_ms : SGD_BUDGET_MS, epochs);
+                    free(sw);
+                }
+
+                printf("%4d %7d %-4s %7d %12.2f %10lld %10.2f %12.3f %18s\n", dim, n,
+                       DCD_LOSS_NAMES[loss], s.passes, (double)s.visits / n, s.updates, ms, obj,
+                       sgd_buf);
+                dcd_free(&s);
+            }
+            free(X);
+            free(y);
+        }
+    }
+    printf("\n");
+}
+
+// ── Multiclass ──────────────────────────────────────────────
+
+// `classes` unit Gaussians around random centers at distance `spread`
+// from the origin, labels 0 .. classes - 1.
+void make_multi_blobs(float *X, int *labels, int n, int dim, int classes, float spread,
+                      unsigned seed) {
+    srand(seed);
+    float *centers = malloc(sizeof(float) * classes * dim);
+    for (int c = 0; c < classes; c++) {
+        float norm = 0;
+        for (int d = 0; d < dim; d++) {
+            centers[c * dim + d] = randn();
+            norm += centers[c * dim + d] * centers[c * dim + d];
+        }
+        for (int d = 0; d < dim; d++) centers[c * dim + d] *= spread / sqrtf(norm);
+    }
+    for (int i = 0; i < n; i++) {
+        labels[i] = i % classes;
+        for (int d = 0; d < dim; d++)
+            X[(size_t)i * dim + d] = centers[labels[i] * dim + d] + randn();
+    }
+    free(centers);
+}
+
+void bench_multiclass(void) {
+    int n = 100000, dim = 32;
+    int threads = pool_default_threads();
+    ThreadPool pool;
+    pool_init(&pool, threads);
+
+    printf("== multiclass linear SVM (DCD, L1, C = 1), %d x %d blobs, %d threads ==\n", n, dim,
+           threads);
+    printf("%7s %-12s %6s %12s %12s %12s %10s\n", "classes", "mode", "models", "serial ms",
+           "pool ms", "predict ns", "accuracy");
+
+    int class_counts[] = {3, 10};
+    float *X = malloc(sizeof(float) * n * dim);
+    int *labels = malloc(sizeof(int) * n);
+    int *pred = malloc(sizeof(int) * n);
+    for (int ci = 0; ci < 2; ci++) {
+        int classes = class_counts[ci];
+        make_multi_blobs(X, labels, n, dim, classes, 4.0f, 5);
+        for (int mode = 0; mode < MULTI_MODE_COUNT; mode++) {
+            MultiSvm m;
+            multi_init(&m, mode, classes, dim, DCD_L1_LOSS, 1.0);
+            double t0 = now_ms();
+            multi_train(&m, X, labels, n, NULL);
+            double serial_ms = now_ms() - t0;
+            t0 = now_ms();
+            multi_train(&m, X, labels, n, &pool);
+            double pool_ms = now_ms() - t0;
+
+            t0 = now_ms();
+            int correct = multi_predict_batch(&m, X, n, pred, labels);
+            double predict_ns = (now_ms() - t0) * 1e6 / n;
+            printf("%7d %-12s %6d %12.1f %12.1f %12.1f %9.2f%%\n", classes,
+                   MULTI_MODE_NAMES[mode], m.models, serial_ms, pool_ms, predict_ns,
+                   100.0 * correct / n);
+            multi_free(&m);
+        }
+    }
+    free(X);
+    free(labels);
+    free(pred);
+    pool_free(&pool);
+    printf("\n");
+}
+
+// ── Pegasos ─────────────────────────────────────────────────
+
+#define PEGASOS_MAX_PASSES 20000
+
+// Passes until lambda/2 |w|^2 + mean hinge is within 1% of the optimum
+// (from DCD at a tight tolerance), lambda = 1/n as in svm.c's loss.
+void bench_pegasos_passes(void) {
+    int dim = 2;
+    // The last run is batch 16 with the schedule offset svm.c uses
+    int batches[] = {1, 16, 256, 16};
+    printf("== Pegasos vs the train() rule: passes to within 1%% of the optimum, lambda = 1/n ==\n");
+    printf("%7s %10s %10s %10s %10s %10s %14s\n", "n", "optimum", "train()", "batch 1",
+           "batch 16", "batch 256", "16, t0 = 1/l");
+
+    for (int n = 150; n <= 15000; n *= 10) {
+        float lambda = 1.0f / n;
+        double C = 1.0 / (lambda * n);
+        float *X = malloc(sizeof(float) * n * dim);
+        int *y = malloc(sizeof(int) * n);
+        make_blobs(X, y, n, dim, 4.0f, 13);
+
+        DcdSvm ref;
+        dcd_init(&ref, n, dim, DCD_L1_LOSS, C);
+        ref.eps = 1e-3;
+        ref.max_passes = 100000;
+        dcd_train(&ref, X, y);
+        double best = lambda * linear_primal(X, y, n, dim, ref.w, ref.w[dim], C);
+        dcd_free(&ref);
+
+        float w[2] = {0}, b = 0;
+        int passes = 0;
+        double obj = INFINITY;
+        while (passes < PEGASOS_MAX_PASSES && obj > best * 1.01) {
+            sgd_epoch(X, y, n, dim, w, &b, 1e-4f, lambda);
+            passes++;
+            obj = lambda * linear_primal(X, y, n, dim, w, b, C);
+        }
+        printf("%7d %10.5f %10d", n, best, passes);
+
+        for (int bi = 0; bi < 4; bi++) {
+            Pegasos pg;
+            pegasos_init(&pg, dim, lambda, batches[bi], true);
+            if (bi == 3) pg.t0 = 1.0f / lambda;
+            obj = INFINITY;
+            while (pg.epochs < PEGASOS_MAX_PASSES && obj > best * 1.01) {
+                pegasos_epoch(&pg, X, y, n, NULL);
+                obj = pegasos_objective(&pg, X, y, n);
+            }
+            printf(bi == 3 ? " %14d" : " %10d", pg.epochs);
+            pegasos_free(&pg);
+        }
+        printf("\n");
+        free(X);
+        free(y);
+    }
+    printf("\n");
+}
+
+// Time per pass on a larger problem, by batch size, with and without the pool.
+void bench_pegasos_scaling(void) {
+    int n = 100000, dim = 32, passes = 5;
+    float lambda = 1e-4f;
+    int threads = pool_default_threads();
+    ThreadPool pool;
+    pool_init(&pool, threads);
+
+    float *X = malloc(sizeof(float) * n * dim);
+    int *y = malloc(sizeof(int) * n);
+    make_blobs(X, y, n, dim, 2.0f, 13);
+
+    printf("== Pegasos pass time, %d x %d blobs, lambda = %g, %d threads ==\n", n, dim, lambda,
+           threads);
+    printf("%7s %12s %12s %12s\n", "batch", "serial ms", "pool ms", "objective");
+    int batches[] = {1, 16, 256, 4096};
+    for (int bi = 0; bi < 4; bi++) {
+        double ms[2];
+        double obj = 0;
+        for (int pooled = 0; pooled < 2; pooled++) {
+            Pegasos pg;
+            pegasos_init(&pg, dim, lambda, batches[bi], true);
+            double t0 = now_ms();
+            for (int e = 0; e < passes; e++) pegasos_epoch(&pg, X, y, n, pooled ? &pool : NULL);
+            ms[pooled] = (now_ms() - t0) / passes;
+            obj = pegasos_objective(&pg, X, y, n);
+            pegasos_free(&pg);
+        }
+        printf("%7d %12.2f %12.2f %12.5f\n", batches[bi], ms[0], ms[1], obj);
+    }
+    printf("\n");
+
+    free(X);
+    free(y);
+    pool_free(&pool);
+}
+
+#define PEGASOS_CHECK_THREADS 4
+
+// Pooled and serial epochs must agree exactly: the batch is chunked the
+// same way either way. The pool is oversized and the batches hold more
+// chunks than it has threads, so workers run several chunks each.
+void bench_pegasos_check(void) {
+    int n = 20000, dim = 8, passes = 3;
+    ThreadPool pool;
+    pool_init(&pool, PEGASOS_CHECK_THREADS);
+    float *X = malloc(sizeof(float) * n * dim);
+    int *y = malloc(sizeof(int) * n);
+    make_blobs(X, y, n, dim, 2.0f, 17);
+
+    printf("== Pegasos pooled vs serial, %d x %d, %d threads, %d epochs ==\n", n, dim,
+           PEGASOS_CHECK_THREADS, passes);
+    printf("%7s %7s %12s %12s %12s %8s\n", "batch", "chunks", "serial b", "pool b",
+           "violators", "match");
+    int batches[] = {1024, 4096};
+    for (int bi = 0; bi < 2; bi++) {
+        Pegasos pg[2];
+        int violators[2] = {0, 0};
+        for (int pooled = 0; pooled < 2; pooled++) {
+            pegasos_init(&pg[pooled], dim, 1e-4f, batches[bi], true);
+            for (int e = 0; e < passes; e++)
+                violators[pooled] += pegasos_epoch(&pg[pooled], X, y, n, pooled ? &pool : NULL);
+        }
+        bool match = violators[0] == violators[1] && pg[0].b == pg[1].b &&
+                     memcmp(pg[0].w, pg[1].w, sizeof(float) * dim) == 0;
+        printf("%7d %7d %12.4f %12.4f %5d/%-6d %8s\n", batches[bi],
+               (batches[bi] + PEGASOS_CHUNK - 1) / PEGASOS_CHUNK, pg[0].b, pg[1].b, violators[0],
+               violators[1], match ? "yes" : "NO");
+        pegasos_free(&pg[0]);
+        pegasos_free(&pg[1]);
+    }
+    printf("\n");
+
+    free(X);
+    free(y);
+    pool_free(&pool);
+}
+
+void bench_pegasos(void) {
+    bench_pegasos_passes();
+    bench_pegasos_scaling();
+    bench_pegasos_check();
+}
+
+// ── Random Fourier features ─────────────────────────────────
+
+#define RFF_TRAIN 10000
+#define RFF_TEST 5000
+#define RFF_KERNEL_PAIRS 2000
+
+// Exact RBF SMO against DCD on D random features, on the circles. Predict
+// times are per test row: the SMO one sums over the support vectors, the
+// RFF one is the transform plus a dot product of length D.
+void bench_rff(void) {
+    float gamma = 0.5f;
+    double C = 1.0;
+    float *X = malloc(sizeof(float) * RFF_TRAIN * 2);
+    float *Xt = malloc(sizeof(float) * RFF_TEST * 2);
+    int *y = malloc(sizeof(int) * RFF_TRAIN);
+    int *yt = malloc(sizeof(int) * RFF_TEST);
+    make_circles(X, y, RFF_TRAIN, 0.05f, 11);
+    make_circles(Xt, yt, RFF_TEST, 0.05f, 12);
+
+    printf("== random Fourier features vs exact RBF (gamma = %g, C = %g, circles) ==\n", gamma,
+           C);
+    printf("%d train rows, %d test rows; kernel error is mean |z(x).z(y) - K(x, y)| over %d pairs\n",
+           RFF_TRAIN, RFF_TEST, RFF_KERNEL_PAIRS);
+    printf("%-10s %10s %12s %10s %10s %12s %10s\n", "model", "kernel err", "rows/s", "train ms",
+           "test acc", "predict us", "model KB");
+
+    SmoSolver s;
+    double t0 = now_ms();
+    smo_init(&s, X, y, RFF_TRAIN, 2, (Kernel){.kind = KERNEL_RBF, .gamma = gamma}, C);
+    smo_set_cache_bytes(&s, 256u << 20);
+    smo_run(&s, 0);
+    double train_ms = now_ms() - t0;
+    int correct = 0;
+    t0 = now_ms();
+    for (int i = 0; i < RFF_TEST; i++) correct += (smo_decision(&s, Xt + 2 * i) > 0) == (yt[i] > 0);
+    double predict_ms = now_ms() - t0;
+    int sv = smo_support_count(&s, NULL);
+    printf("%-10s %10s %12s %10.1f %9.1f%% %12.2f %10.1f\n", "exact", "0", "-", train_ms,
+           100.0 * correct / RFF_TEST, 1000.0 * predict_ms / RFF_TEST,
+           sv * (2 + 1) * sizeof(float) / 1024.0);
+    smo_free(&s);
+
+    int outs[] = {16, 64, 256, 1024};
+    for (size_t o = 0; o < sizeof(outs) / sizeof(outs[0]); o++) {
+        int D = outs[o];
+        RffMap map;
+        rff_init(&map, 2, D, gamma, 42);
+        float *Z = malloc(sizeof(float) * (size_t)RFF_TRAIN * D);
+        float *zt = malloc(sizeof(float) * D);
+
+        double err = 0;
+        float *pair = malloc(sizeof(float) * 2 * D);
+        for (int p = 0; p < RFF_KERNEL_PAIRS; p++) {
+            const float *a = X + 2 * (rand() % RFF_TRAIN), *b = X + 2 * (rand() % RFF_TRAIN);
+            rff_transform(&map, a, 1, pair);
+            rff_transform(&map, b, 1, pair + D);
+            float dx = a[0] - b[0], dy = a[1] - b[1];
+            err += fabs(pegasos_dot(pair, pair + D, D) - expf(-gamma * (dx * dx + dy * dy)));
+        }
+        free(pair);
+
+        t0 = now_ms();
+        rff_transform(&map, X, RFF_TRAIN, Z);
+        double transform_ms = now_ms() - t0;
+
+        DcdSvm d;
+        dcd_init(&d, RFF_TRAIN, D, DCD_L1_LOSS, C);
+        t0 = now_ms();
+        dcd_train(&d, Z, y);
+        train_ms = now_ms() - t0;
+
+        correct = 0;
+        t0 = now_ms();
+        for (int i = 0; i < RFF_TEST; i++) {
+            rff_transform(&map, Xt + 2 * i, 1, zt);
+            correct += (dcd_decision(&d, zt) > 0) == (yt[i] > 0);
+        }
+        predict_ms = now_ms() - t0;
+
+        char name[16];
+        snprintf(name, sizeof(name), "rff %d", D);
+        printf("%-10s %10.4f %12.0f %10.1f %9.1f%% %12.2f %10.1f\n", name,
+               err / RFF_KERNEL_PAIRS, RFF_TRAIN / (transform_ms / 1000.0), train_ms,
+               100.0 * correct / RFF_TEST, 1000.0 * predict_ms / RFF_TEST,
+               ((size_t)map.cap * 3 + D + 1) * sizeof(float) / 1024.0);
+        dcd_free(&d);
+        rff_free(&map);
+        free(Z);
+        free(zt);
+    }
+    free(X);
+    free(Xt);
+    free(y);
+    free(yt);
+    printf("\n");
+}
+
+// ── Nyström ─────────────────────────────────────────────────
+
+#define NYSTROM_TRAIN 100000
+#define NYSTROM_TEST 5000
+#define NYSTROM_GRAM_ROWS 200
+
+// Nyström features + DCD at 10^5 circles against what the full Gram matrix
+// would cost: its size, and its build time extrapolated from
+// NYSTROM_GRAM_ROWS rows.
+void bench_nystrom(void) {
+    Kernel rbf = {.kind = KERNEL_RBF, .gamma = 0.5f};
+    double C = 1.0;
+    int n = NYSTROM_TRAIN;
+    float *X = malloc(sizeof(float) * n * 2);
+    float *Xt = malloc(sizeof(float) * NYSTROM_TEST * 2);
+    int *y = malloc(sizeof(int) * n);
+    int *yt = malloc(sizeof(int) * NYSTROM_TEST);
+    make_circles(X, y, n, 0.05f, 11);
+    make_circles(Xt, yt, NYSTROM_TEST, 0.05f, 12);
+
+    int cap = (n + 3) & ~3;
+    float *cols = calloc((size_t)2 * cap, sizeof(float));
+    for (int i = 0; i < n; i++) {
+        cols[i] = X[2 * i];
+        cols[cap + i] = X[2 * i + 1];
+    }
+    float *row = malloc(sizeof(float) * cap);
+    double t0 = now_ms();
+    for (int i = 0; i < NYSTROM_GRAM_ROWS; i++) kernel_row(&rbf, X + 2 * i, cols, cap, n, 2, row);
+    double gram_ms = (now_ms() - t0) * n / NYSTROM_GRAM_ROWS;
+    free(row);
+    free(cols);
+
+    printf("== Nystrom features vs the full Gram matrix (rbf gamma = %g, C = %g, circles) ==\n",
+           rbf.gamma, C);
+    printf("full Gram at n = %d: %.1f GB, ~%.1f s to fill (from %d rows)\n", n,
+           (double)n * n * sizeof(float) / 1e9, gram_ms / 1000.0, NYSTROM_GRAM_ROWS);
+    printf("memory is landmarks + K^-1/2 + the n x m features; kernel error as in \"rff\"\n");
+    printf("%-9s %5s %5s %7s %10s %10s %10s %10s %9s %10s\n", "sampling", "m", "rank", "sweeps",
+           "kernel err", "setup ms", "xform ms", "train ms", "test acc", "memory MB");
+
+    int ms[] = {16, 64, 256};
+    for (int sampling = 0; sampling < NYSTROM_SAMPLING_COUNT; sampling++) {
+        for (size_t k = 0; k < sizeof(ms) / sizeof(ms[0]); k++) {
+            int m = ms[k];
+            NystromMap nm;
+            t0 = now_ms();
+            nystrom_init(&nm, rbf, X, n, 2, m, sampling, 42);
+            double setup_ms = now_ms() - t0;
+
+            float *pair = malloc(sizeof(float) * 2 * m);
+            double err = 0;
+            for (int p = 0; p < RFF_KERNEL_PAIRS; p++) {
+                const float *a = X + 2 * (rand() % n), *b = X + 2 * (rand() % n);
+                nystrom_transform(&nm, a, 1, pair);
+                nystrom_transform(&nm, b, 1, pair + m);
+                err += fabs(pegasos_dot(pair, pair + m, m) - kernel_eval(&rbf, a, b, 2));
+            }
+
+            float *Z = malloc(sizeof(float) * (size_t)n * m);
+            t0 = now_ms();
+            nystrom_transform(&nm, X, n, Z);
+            double xform_ms = now_ms() - t0;
+
+            DcdSvm d;
+            dcd_init(&d, n, m, DCD_L1_LOSS, C);
+            t0 = now_ms();
+            dcd_train(&d, Z, y);
+            double train_ms = now_ms() - t0;
+
+            int correct = 0;
+            for (int i = 0; i < NYSTROM_TEST; i++) {
+                nystrom_transform(&nm, Xt + 2 * i, 1, pair);
+                correct += (dcd_decision(&d, pair) > 0) == (yt[i] > 0);
+            }
+            double bytes = ((double)2 * nm.cap + (double)m * nm.cap + (double)n * m) * sizeof(float);
+            printf("%-9s %5d %5d %7d %10.4f %10.1f %10.1f %10.1f %8.1f%% %10.1f\n",
+                   NYSTROM_SAMPLING_NAMES[sampling], m, nm.rank, nm.sweeps,
+                   err / RFF_KERNEL_PAIRS, setup_ms, xform_ms, train_ms,
+                   100.0 * correct / NYSTROM_TEST, bytes / 1048576.0);
+            dcd_free(&d);
+            nystrom_free(&nm);
+            free(Z);
+            free(pair);
+        }
+    }
+    free(X);
+    free(Xt);
+    free(y);
+    free(yt);
+    printf("\n");
+}
+
+// ── Support vector compaction ───────────────────────────────
+
+#define COMPACT_QUERIES 20000
+
+typedef struct {
+    const char *data;
+    int n;
+    float noise;
+    Kernel kernel;
+} CompactCase;
+
+// Per-row latency of smo_decision() (all n points) against the compacted
+// model's batch path, and the largest disagreement between the two.
+void bench_compact(void) {
+    CompactCase cases[] = {
+        {"circles", 2000, 0.05f, {.kind = KERNEL_RBF, .gamma = 0.5f}},
+        {"circles", 8000, 0.05f, {.kind = KERNEL_RBF, .gamma = 0.5f}},
+        {"circles", 8000, 0.20f, {.kind = KERNEL_RBF, .gamma = 0.5f}},
+        {"circles", 8000, 0.05f, {.kind = KERNEL_POLY, .gamma = 0.25f, .coef0 = 1.0f, .degree = 2}},
+        {"blobs2", 8000, 0, {.kind = KERNEL_LINEAR}},
+    };
+    double C = 1.0;
+    float *Q = malloc(sizeof(float) * COMPACT_QUERIES * 2);
+    int *qy = malloc(sizeof(int) * COMPACT_QUERIES);
+    float *out = malloc(sizeof(float) * COMPACT_QUERIES);
+
+    printf("== support vector compaction (SMO, C = %g), %d queries ==\n", C, COMPACT_QUERIES);
+    printf("%-8s %-6s %6s %6s %10s %10s %12s %12s %9s %10s\n", "data", "kernel", "n", "SVs",
+           "full KB", "model KB", "full us/row", "model us/row", "speedup", "max |diff|");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        CompactCase cc = cases[c];
+        float *X = malloc(sizeof(float) * cc.n * 2);
+        int *y = malloc(sizeof(int) * cc.n);
+        if (cc.kernel.kind == KERNEL_LINEAR) {
+            make_blobs(X, y, cc.n, 2, 3.0f, 11);
+            make_blobs(Q, qy, COMPACT_QUERIES, 2, 3.0f, 12);
+        } else {
+            make_circles(X, y, cc.n, cc.noise, 11);
+            make_circles(Q, qy, COMPACT_QUERIES, cc.noise, 12);
+        }
+
+        SmoSolver s;
+        smo_init(&s, X, y, cc.n, 2, cc.kernel, C);
+        smo_set_cache_bytes(&s, 256u << 20);
+        smo_run(&s, 0);
+
+        double t0 = now_ms(), max_diff = 0;
+        float *full = malloc(sizeof(float) * COMPACT_QUERIES);
+        for (int i = 0; i < COMPACT_QUERIES; i++) full[i] = (float)smo_decision(&s, Q + 2 * i);
+        double full_ms = now_ms() - t0;
+
+        SvModel m;
+        svmodel_compact(&m, &s);
+        t0 = now_ms();
+        svmodel_predict_batch(&m, Q, COMPACT_QUERIES, out);
+        double model_ms = now_ms() - t0;
+        for (int i = 0; i < COMPACT_QUERIES; i++)
+            if (fabs(out[i] - full[i]) > max_diff) max_diff = fabs(out[i] - full[i]);
+
+        // What smo_decision() reads: the input columns, labels and alphas
+        double full_kb = (2.0 * s.cap * sizeof(float) + cc.n * (sizeof(int) + sizeof(double))) / 1024;
+        printf("%-8s %-6s %6d %6d %10.1f %10.2f %12.3f %12.3f %8.1fx %10.2e\n", cc.data,
+               KERNEL_NAMES[cc.kernel.kind], cc.n, m.count, full_kb, svmodel_bytes(&m) / 1024.0,
+               1000.0 * full_ms / COMPACT_QUERIES, 1000.0 * model_ms / COMPACT_QUERIES,
+               full_ms / model_ms, max_diff);
+        svmodel_free(&m);
+        smo_free(&s);
+        free(full);
+        free(X);
+        free(y);
+    }
+    free(Q);
+    free(qy);
+    free(out);
+    printf("\n");
+}
+
+// ── Incremental updates ─────────────────────────────────────
+
+// incremental.h against INCR_BENCH_EPOCHS full epochs of train()'s rule
+// (sgd_epoch) per appended point. Each case warms up on n points, then
+// appends INCR_ADDS more one at a time, starting both paths from the same
+// parameters every time.
+#define INCR_BENCH_EPOCHS 200
+#define INCR_BENCH_SLACK 0.5f
+#define INCR_WARMUP 50
+#define INCR_ADDS 8
+
+void bench_incremental(void) {
+    int sizes[] = {1000, 10000, 100000};
+    float lr = 1e-3f, lambda = 1e-2f;
+
+    printf("== incremental updates: %d epochs of train()'s rule per point, lr %g, lambda %g ==\n",
+           INCR_BENCH_EPOCHS, lr, lambda);
+    printf("%7s %5s %9s %8s %12s %12s %9s %10s %10s\n", "n", "adds", "affected", "rescans",
+           "full ms/pt", "incr ms/pt", "speedup", "max |dw|", "max |db|");
+
+    for (size_t c = 0; c < sizeof(sizes) / sizeof(sizes[0]); c++) {
+        int n = sizes[c], total = n + INCR_ADDS;
+        float *X = malloc(sizeof(float) * total * 2);
+        int *y = malloc(sizeof(int) * total);
+        make_blobs(X, y, total, 2, 6.0f, 13);
+
+        float w[2] = {0}, b = 0;
+        for (int e = 0; e < INCR_WARMUP; e++) sgd_epoch(X, y, n, 2, w, &b, lr, lambda);
+
+        IncrSvm inc;
+        incr_init(&inc, 2, INCR_BENCH_EPOCHS, INCR_BENCH_SLACK);
+        incr_update(&inc, X, y, n, w, &b, lr, lambda);  // the first scan, untimed
+
+        double full_ms = 0, incr_ms = 0, max_dw = 0, max_db = 0;
+        long affected = 0;
+        int rescans = 0;
+        for (int k = n + 1; k <= total; k++) {
+            float w_ref[2] = {w[0], w[1]}, b_ref = b;
+            double t0 = now_ms();
+            for (int e = 0; e < INCR_BENCH_EPOCHS; e++)
+                sgd_epoch(X, y, k, 2, w_ref, &b_ref, lr, lambda);
+            full_ms += now_ms() - t0;
+
+            t0 = now_ms();
+            incr_update(&inc, X, y, k, w, &b, lr, lambda);
+            incr_ms += now_ms() - t0;
+            affected += inc.count;
+            rescans += inc.rescans;
+
+            for (int d = 0; d < 2; d++)
+                if (fabs(w[d] - w_ref[d]) > max_dw) max_dw = fabs(w[d] - w_ref[d]);
+            if (fabs(b - b_ref) > max_db) max_db = fabs(b - b_ref);
+        }
+        printf("%7d %5d %9ld %8d %12.3f %12.3f %8.1fx %10.2e %10.2e\n", n, INCR_ADDS,
+               affected / INCR_ADDS, rescans, full_ms / INCR_ADDS, incr_ms / INCR_ADDS,
+               full_ms / incr_ms, max_dw, max_db);
+        incr_free(&inc);
+        free(X);
+        free(y);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    const char *section = argc > 1 ? argv[1] : "all";
+
+    if (strcmp(section, "all") == 0 || strcmp(section, "smo") == 0)
+        bench_smo();
+    if (strcmp(section, "all") == 0 || strcmp(section, "kernel") == 0)
+        bench_kernel();
+    if (strcmp(section, "all") == 0 || strcmp(section, "dcd") == 0)
+        bench_dcd();
+    if (strcmp(section, "all") == 0 || strcmp(section, "multiclass") == 0)
+        bench_multiclass();
+    if (strcmp(section, "all") == 0 || strcmp(section, "pegasos") == 0)
+        bench_pegasos();
+    if (strcmp(section, "all") == 0 || strcmp(section, "rff") == 0)
+        bench_rff();
+    if (strcmp(section, "all") == 0 || strcmp(section, "nystrom") == 0)
+        bench_nystrom();
+    if (strcmp(section, "all") == 0 || strcmp(section, "compact") == 0)
+        bench_compact();
+    if (strcmp(section, "all") == 0 || strcmp(section, "incremental") == 0)
+        bench_incremental();
+
+    return 0;
+}
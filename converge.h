@@ -0,0 +1,95 @@
+#ifndef CONVERGE_H
+#define CONVERGE_H
+
+#include <math.h>
+#include <stdbool.h>
+
+// Watches a training loss in blocks of CONVERGE_WINDOW steps. When a block
+// fills, the caller passes the current gradient norm; the block's loss
+// slope, its mean against the previous block, and that norm decide whether
+// training converged, diverged or should keep going. Pushing is O(1), the
+// check is O(window) once per window.
+
+#define CONVERGE_WINDOW 64
+
+typedef enum {
+    CONV_RUNNING = 0,
+    CONV_CONVERGED,
+    CONV_DIVERGED,
+} ConvergeState;
+
+const char *CONVERGE_STATE_NAMES[] = {"running", "converged", "diverged"};
+
+typedef struct {
+    float slope_tol;      // relative loss change per window that counts as flat
+    float abs_tol;        // absolute loss change per window that counts as flat
+    float grad_tol;       // gradient norm that counts as stationary
+    float diverge_ratio;  // loss growth between windows that counts as divergence
+
+    float loss[CONVERGE_WINDOW];
+    int count;
+    float prev_mean;      // mean loss of the previous window, < 0 if none
+    float slope;          // loss change across the last window
+    float grad_norm;
+    ConvergeState state;
+} ConvergeMonitor;
+
+void converge_resume(ConvergeMonitor *m) {
+    m->count = 0;
+    m->prev_mean = -1.0f;
+    m->slope = 0;
+    m->grad_norm = 0;
+    m->state = CONV_RUNNING;
+}
+
+void converge_init(ConvergeMonitor *m, float slope_tol, float abs_tol, float grad_tol) {
+    m->slope_tol = slope_tol;
+    m->abs_tol = abs_tol;
+    m->grad_tol = grad_tol;
+    m->diverge_ratio = 4.0f;
+    converge_resume(m);
+}
+
+// Records one loss value. Returns true when a window is full and
+// converge_check() should be called.
+bool converge_push(ConvergeMonitor *m, float loss) {
+    if (m->count < CONVERGE_WINDOW) m->loss[m->count++] = loss;
+    return m->count == CONVERGE_WINDOW;
+}
+
+ConvergeState converge_check(ConvergeMonitor *m, float grad_norm) {
+    int n = m->count;
+    if (n < 2) return m->state;
+
+    float mean = 0;
+    for (int i = 0; i < n; i++) mean += m->loss[i];
+    mean /= n;
+
+    // Least-squares slope, scaled to the change across the window
+    float mx = (n - 1) * 0.5f;
+    float sxy = 0, sxx = 0;
+    for (int i = 0; i < n; i++) {
+        float dx = i - mx;
+        sxy += dx * (m->loss[i] - mean);
+        sxx += dx * dx;
+    }
+    m->slope = sxy / sxx * n;
+    m->grad_norm = grad_norm;
+
+    float flat = m->slope_tol * fabsf(mean) + m->abs_tol;
+    bool have_prev = m->prev_mean >= 0;
+
+    if (!isfinite(mean) || !isfinite(grad_norm) ||
+        (have_prev && mean > m->prev_mean * m->diverge_ratio + m->abs_tol)) {
+        m->state = CONV_DIVERGED;
+    } else if (have_prev && fabsf(mean - m->prev_mean) < flat &&
+               (fabsf(m->slope) < flat || grad_norm < m->grad_tol)) {
+        m->state = CONV_CONVERGED;
+    }
+
+    m->prev_mean = mean;
+    m->count = 0;
+    return m->state;
+}
+
+#endif
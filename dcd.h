@@ -0,0 +1,199 @@
+#ifndef DCD_H
+#define DCD_H
+
+// Dual coordinate descent for the linear SVM (Hsieh et al. 2008, the
+// LIBLINEAR solver)
+//
+//     min  1/2 |w|^2 + C sum loss(1 - y_i w.x_i)
+//     L1:  loss(h) = max(0, h)       L2:  loss(h) = max(0, h)^2
+//
+// Each pass visits the dual variables in a fresh random order and solves
+// for one alpha_i in closed form, keeping w = sum alpha_i y_i x_i up to
+// date, so a step costs two dot products of length dim. Variables that sit
+// at a bound and whose projected gradient points out of the box by more
+// than last pass's extremes are shrunk: swapped past `active_size` and
+// skipped until the active set converges, at which point everything is
+// checked once more.
+//
+// The bias is learned as the weight of a constant feature 1, so unlike
+// svm.c's loss it is regularized along with w.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef enum {
+    DCD_L1_LOSS = 0,    // hinge
+    DCD_L2_LOSS,        // squared hinge
+    DCD_LOSS_COUNT
+} DcdLoss;
+
+const char *DCD_LOSS_NAMES[DCD_LOSS_COUNT] = {"L1", "L2"};
+
+typedef struct {
+    int n;
+    int dim;
+    DcdLoss loss;
+    double C;
+    double eps;             // stop once max - min projected gradient < eps
+    int max_passes;
+
+    float *w;               // dim weights, then the bias
+    double *alpha;
+    float *qd;              // Q_ii = |x_i|^2 + 1 (+ 1 / 2C for L2)
+    int *index;             // permutation; [0, active_size) is active
+    int active_size;
+    uint32_t rng;
+
+    int passes;
+    long long visits;       // coordinates looked at, across all passes
+    long long updates;      // coordinates that moved
+    bool converged;
+} DcdSvm;
+
+void dcd_init(DcdSvm *s, int n, int dim, DcdLoss loss, double C) {
+    *s = (DcdSvm){0};
+    s->n = n;
+    s->dim = dim;
+    s->loss = loss;
+    s->C = C;
+    s->eps = 0.1;
+    s->max_passes = 1000;
+    s->w = calloc(dim + 1, sizeof(float));
+    s->alpha = calloc(n, sizeof(double));
+    s->qd = malloc(sizeof(float) * n);
+    s->index = malloc(sizeof(int) * n);
+    s->rng = 0x9e3779b9u;
+}
+
+void dcd_free(DcdSvm *s) {
+    free(s->w);
+    free(s->alpha);
+    free(s->qd);
+    free(s->index);
+    *s = (DcdSvm){0};
+}
+
+uint32_t dcd_rand(DcdSvm *s) {
+    uint32_t x = s->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return s->rng = x;
+}
+
+// w.x + b for a row of dim values
+float dcd_decision(const DcdSvm *s, const float *x) {
+    float f = s->w[s->dim];
+    for (int d = 0; d < s->dim; d++) f += s->w[d] * x[d];
+    return f;
+}
+
+// Moves active entry k to the end of the active range and drops it.
+void dcd_shrink(DcdSvm *s, int k) {
+    s->active_size--;
+    int tmp = s->index[k];
+    s->index[k] = s->index[s->active_size];
+    s->index[s->active_size] = tmp;
+}
+
+// Trains on n row-major samples with labels +1 / -1 from alpha = 0.
+// Returns true if the projected gradient converged within max_passes.
+bool dcd_train(DcdSvm *s, const float *X, const int *y) {
+    int n = s->n, dim = s->dim;
+    double upper = s->loss == DCD_L1_LOSS ? s->C : INFINITY;
+    double diag = s->loss == DCD_L1_LOSS ? 0.0 : 0.5 / s->C;
+
+    for (int d = 0; d <= dim; d++) s->w[d] = 0;
+    for (int i = 0; i < n; i++) {
+        const float *x = X + (size_t)i * dim;
+        float sq = 1.0f;
+        for (int d = 0; d < dim; d++) sq += x[d] * x[d];
+        s->qd[i] = sq + (float)diag;
+        s->alpha[i] = 0;
+        s->index[i] = i;
+    }
+    s->active_size = n;
+    s->passes = 0;
+    s->visits = s->updates = 0;
+    s->converged = false;
+
+    double pg_max_old = INFINITY, pg_min_old = -INFINITY;
+    while (s->passes < s->max_passes) {
+        double pg_max = -INFINITY, pg_min = INFINITY;
+
+        for (int k = 0; k < s->active_size; k++) {
+            int r = k + (int)(dcd_rand(s) % (uint32_t)(s->active_size - k));
+            int tmp = s->index[k];
+            s->index[k] = s->index[r];
+            s->index[r] = tmp;
+        }
+
+        for (int k = 0; k < s->active_size; k++) {
+            int i = s->index[k];
+            const float *x = X + (size_t)i * dim;
+            double yi = y[i];
+            double g = yi * dcd_decision(s, x) - 1.0 + diag * s->alpha[i];
+            s->visits++;
+
+            double pg = 0;
+            if (s->alpha[i] == 0) {
+                if (g > pg_max_old) {
+                    dcd_shrink(s, k--);
+                    continue;
+                }
+                if (g < 0) pg = g;
+            } else if (s->alpha[i] == upper) {
+                if (g < pg_min_old) {
+                    dcd_shrink(s, k--);
+                    continue;
+                }
+                if (g > 0) pg = g;
+            } else {
+                pg = g;
+            }
+            if (pg > pg_max) pg_max = pg;
+            if (pg < pg_min) pg_min = pg;
+
+            if (fabs(pg) > 1e-12) {
+                double old = s->alpha[i];
+                double a = old - g / s->qd[i];
+                s->alpha[i] = a < 0 ? 0 : (a > upper ? upper : a);
+                float step = (float)((s->alpha[i] - old) * yi);
+                for (int d = 0; d < dim; d++) s->w[d] += step * x[d];
+                s->w[dim] += step;
+                s->updates++;
+            }
+        }
+        s->passes++;
+
+        if (pg_max - pg_min <= s->eps) {
+            if (s->active_size == n) {
+                s->converged = true;
+                break;
+            }
+            // The shrunk set may hide violators; re-check everything once
+            s->active_size = n;
+            pg_max_old = INFINITY;
+            pg_min_old = -INFINITY;
+            continue;
+        }
+        pg_max_old = pg_max > 0 ? pg_max : INFINITY;
+        pg_min_old = pg_min < 0 ? pg_min : -INFINITY;
+    }
+    return s->converged;
+}
+
+// 1/2 |w|^2 + C sum loss, with the bias regularized as in dcd_train()
+double dcd_primal(const DcdSvm *s, const float *X, const int *y) {
+    double obj = 0;
+    for (int d = 0; d <= s->dim; d++) obj += 0.5 * s->w[d] * s->w[d];
+    for (int i = 0; i < s->n; i++) {
+        double h = 1.0 - y[i] * dcd_decision(s, X + (size_t)i * s->dim);
+        if (h > 0) obj += s->C * (s->loss == DCD_L1_LOSS ? h : h * h);
+    }
+    return obj;
+}
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef HOGWILD_H
+#define HOGWILD_H
+
+// Parallel SGD epochs for the Perceptron on large datasets. Include
+// perceptron.h and pool.h first.
+//
+// PAR_HOGWILD: every worker runs plain SGD over its own shard of rows and
+// writes straight into the shared weights without locks (Hogwild!). Updates
+// from different shards race, which is the point: with sparse-ish conflicts
+// they rarely collide, and nobody waits. Results depend on timing.
+//
+// PAR_AVERAGE: the deterministic fallback. The rows are split into a fixed
+// PAR_AVERAGE_SHARDS shards whatever the thread count; each trains a private
+// copy of the weights from the same start and the copies are averaged in
+// shard order, so the result is the same on every machine.
+//
+// Both use the plain SGD rule with the optimizer's scheduled learning rate:
+// Momentum, Nesterov and Adam state is not carried across shards.
+
+typedef enum {
+    PAR_SERIAL = 0,
+    PAR_HOGWILD,
+    PAR_AVERAGE,
+    PAR_MODE_COUNT
+} ParallelMode;
+
+const char *PARALLEL_MODE_NAMES[PAR_MODE_COUNT] = {"serial", "hogwild", "averaged"};
+
+#define CACHE_LINE 64
+#define PAR_AVERAGE_SHARDS 8
+
+// Per-shard results, one cache line each so workers never share a line
+typedef struct {
+    _Alignas(CACHE_LINE) float total_error;
+    float b;
+    float *w;   // private weights (PAR_AVERAGE only)
+} ShardState;
+
+typedef struct {
+    Perceptron *p;
+    const DatasetInfo *ds;
+    float lr;
+    ParallelMode mode;
+    int num_shards;
+    ShardState *shards;
+} ParallelEpoch;
+
+void parallel_epoch_shard(void *ctx, int shard, int worker) {
+    (void)worker;
+    ParallelEpoch *pe = ctx;
+    const DatasetInfo *ds = pe->ds;
+    ShardState *st = &pe->shards[shard];
+    int n = pe->p->num_weights;
+    int begin = (int)((long long)ds->count * shard / pe->num_shards);
+    int end = (int)((long long)ds->count * (shard + 1) / pe->num_shards);
+
+    float *w = pe->p->w;
+    float *b = &pe->p->b;
+    if (pe->mode == PAR_AVERAGE) {
+        memcpy(st->w, pe->p->w, sizeof(float) * n);
+        st->b = pe->p->b;
+        w = st->w;
+        b = &st->b;
+    }
+
+    float lr = pe->lr;
+    float total_error = 0;
+    for (int i = begin; i < end; i++) {
+        const float *data = dataset_row(ds, i);
+        float sum = *b;
+        for (int j = 0; j < n; j++)
+            sum += w[j] * data[j];
+        float error = activation_fn(sum) - data[ds->dim];
+        total_error += error * error;
+        for (int j = 0; j < n; j++)
+            w[j] -= lr * error * data[j];
+        *b -= lr * error;
+    }
+    st->total_error = total_error;
+}
+
+// One epoch over ds split into pool->num_threads shards (PAR_HOGWILD) or
+// PAR_AVERAGE_SHARDS shards (PAR_AVERAGE).
+void train_step_parallel(Perceptron *p, const Optimizer *opt, const DatasetInfo *ds,
+                         ThreadPool *pool, ParallelMode mode, float *mse) {
+    if (mode == PAR_SERIAL) {
+        train_step(p, opt, ds, mse);
+        return;
+    }
+
+    int shards = mode == PAR_AVERAGE ? PAR_AVERAGE_SHARDS : pool->num_threads;
+    int n = p->num_weights;
+    ShardState *st = aligned_alloc(CACHE_LINE, sizeof(ShardState) * shards);
+    float *private_w = NULL;
+    int w_stride = ((n + 15) / 16) * 16;  // one cache line multiple per shard
+    if (mode == PAR_AVERAGE)
+        private_w = aligned_alloc(CACHE_LINE, sizeof(float) * w_stride * shards);
+    for (int s = 0; s < shards; s++) {
+        st[s] = (ShardState){0};
+        if (private_w) st[s].w = private_w + (size_t)s * w_stride;
+    }
+
+    ParallelEpoch pe = {
+        .p = p,
+        .ds = ds,
+        .lr = optimizer_lr(opt, p->epoch),
+        .mode = mode,
+        .num_shards = shards,
+        .shards = st,
+    };
+    pool_run(pool, parallel_epoch_shard, &pe, shards);
+
+    if (mode == PAR_AVERAGE) {
+        for (int j = 0; j < n; j++) {
+            float sum = 0;
+            for (int s = 0; s < shards; s++) sum += st[s].w[j];
+            p->w[j] = sum / shards;
+        }
+        float bsum = 0;
+        for (int s = 0; s < shards; s++) bsum += st[s].b;
+        p->b = bsum / shards;
+    }
+
+    float total_error = 0;
+    for (int s = 0; s < shards; s++) total_error += st[s].total_error;
+    *mse = ds->count ? total_error / ds->count : 0.0f;
+
+    p->t += ds->count;
+    p->epoch++;
+    p->version++;
+    free(private_w);
+    free(st);
+}
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+// Warm-started updates of a linear SVM trained with svm.c's per-sample rule
+//
+//     y (w.x + b) >= 1:  w <- (1 - lr lambda) w
+//     otherwise:         w <- w - lr (lambda w - y x),   b <- b + lr y
+//
+// after rows are appended to the training set. Instead of restarting, each
+// update runs `epochs` epochs of the rule over only the affected set, the
+// rows with margin <= 1 + slack (new rows always are). Every other row has
+// margin >= 1, where the rule only shrinks w, so the rows between two
+// affected ones are applied as one (1 - lr lambda)^gap factor, in the order
+// a full epoch visits them. An update costs O(epochs x affected) instead of
+// O(epochs x n) and matches full epochs up to rounding; a row sitting right
+// on margin 1 can then take the other branch, a one-step (lr) difference.
+//
+// The affected set comes from one full scan and is kept across updates.
+// A margin moves by at most |w - w_scan| R + |b - b_scan| (R the largest
+// |x|), so the set stays exact while that drift is under the slack; it is
+// checked before every epoch and the set rescanned once it is exceeded, or
+// when w was changed by something else between updates. Within an epoch the
+// drift can overshoot the slack slightly before the next check.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int dim;
+    int epochs;
+    float slack;
+    int n;                  // rows seen by the last update
+    int *active;            // the affected set, ascending
+    int count;
+    int cap;
+    float *w_scan;          // parameters the set was scanned at
+    float b_scan;
+    float *w_last;          // parameters after the last update
+    float b_last;
+    float radius;           // largest |x| seen
+    bool valid;
+    int rescans;            // full scans during the last update
+} IncrSvm;
+
+void incr_init(IncrSvm *s, int dim, int epochs, float slack) {
+    *s = (IncrSvm){0};
+    s->dim = dim;
+    s->epochs = epochs;
+    s->slack = slack;
+    s->w_scan = calloc(dim, sizeof(float));
+    s->w_last = calloc(dim, sizeof(float));
+}
+
+void incr_free(IncrSvm *s) {
+    free(s->active);
+    free(s->w_scan);
+    free(s->w_last);
+    *s = (IncrSvm){0};
+}
+
+void incr_push(IncrSvm *s, int row) {
+    if (s->count == s->cap) {
+        s->cap = s->cap ? 2 * s->cap : 64;
+        s->active = realloc(s->active, sizeof(int) * s->cap);
+    }
+    s->active[s->count++] = row;
+}
+
+float incr_norm(const float *x, int dim) {
+    float sq = 0;
+    for (int d = 0; d < dim; d++) sq += x[d] * x[d];
+    return sqrtf(sq);
+}
+
+float incr_margin(const float *x, int y, const float *w, float b, int dim) {
+    float f = b;
+    for (int d = 0; d < dim; d++) f += w[d] * x[d];
+    return y * f;
+}
+
+float incr_drift(const IncrSvm *s, const float *w, float b) {
+    float sq = 0;
+    for (int d = 0; d < s->dim; d++) sq += (w[d] - s->w_scan[d]) * (w[d] - s->w_scan[d]);
+    return sqrtf(sq) * s->radius + fabsf(b - s->b_scan);
+}
+
+void incr_rescan(IncrSvm *s, const float *X, const int *y, int n, const float *w, float b) {
+    s->count = 0;
+    s->radius = 0;
+    for (int k = 0; k < n; k++) {
+        const float *x = X + (size_t)k * s->dim;
+        float r = incr_norm(x, s->dim);
+        if (r > s->radius) s->radius = r;
+        if (incr_margin(x, y[k], w, b, s->dim) <= 1.0f + s->slack) incr_push(s, k);
+    }
+    memcpy(s->w_scan, w, sizeof(float) * s->dim);
+    s->b_scan = b;
+    s->valid = true;
+    s->rescans++;
+}
+
+// Updates w and b in place after rows [s->n, n) of the n row-major samples
+// (labels +1 / -1) were appended.
+void incr_update(IncrSvm *s, const float *X, const int *y, int n, float *w, float *b, float lr,
+                 float lambda) {
+    int dim = s->dim;
+    s->rescans = 0;
+
+    bool moved = !s->valid || s->b_last != *b || memcmp(s->w_last, w, sizeof(float) * dim) != 0;
+    if (moved) {
+        incr_rescan(s, X, y, n, w, *b);
+    } else {
+        // The newest rows, so the set stays ascending
+        for (int k = s->n; k < n; k++) {
+            float r = incr_norm(X + (size_t)k * dim, dim);
+            if (r > s->radius) s->radius = r;
+            incr_push(s, k);
+        }
+    }
+    s->n = n;
+
+    // log(1 - lr lambda) directly: 1 - lr lambda itself rounds away most of
+    // a small lr lambda in float
+    float log_keep = log1pf(-lr * lambda);
+    for (int e = 0; e < s->epochs; e++) {
+        if (incr_drift(s, w, *b) > s->slack) incr_rescan(s, X, y, n, w, *b);
+        int next = 0;           // first row not yet applied this epoch
+        for (int a = 0; a < s->count; a++) {
+            int k = s->active[a];
+            if (k > next) {
+                float shrink = expf(log_keep * (k - next));
+                for (int d = 0; d < dim; d++) w[d] *= shrink;
+            }
+            next = k + 1;
+
+            const float *x = X + (size_t)k * dim;
+            float yi = (float)y[k];
+            if (incr_margin(x, y[k], w, *b, dim) >= 1) {
+                for (int d = 0; d < dim; d++) w[d] -= lr * lambda * w[d];
+            } else {
+                for (int d = 0; d < dim; d++) w[d] -= lr * (lambda * w[d] - yi * x[d]);
+                *b += lr * yi;
+            }
+        }
+        float shrink = expf(log_keep * (n - next));
+        for (int d = 0; d < dim; d++) w[d] *= shrink;
+    }
+    memcpy(s->w_last, w, sizeof(float) * dim);
+    s->b_last = *b;
+}
+
+#endif
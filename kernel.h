@@ -0,0 +1,284 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+// Kernels and a budgeted kernel perceptron. Plain C, no raylib, so the
+// demos and the headless benches share it.
+//
+// The perceptron keeps at most `budget` support vectors. A mistake on a
+// sample that is already a support vector bumps its coefficient; otherwise
+// the sample joins the set, evicting one member (oldest, or smallest
+// |alpha|) when the budget is full. Prediction is one pass over at most
+// `budget` vectors however long the stream runs.
+//
+// Support vectors are stored column-major (one column of `cap` values per
+// input) so the kernel row against a query is computed four vectors at a
+// time. For repeated epochs over a fixed dataset, a KernelCache keeps
+// K(row, slot) and a per-slot generation counter invalidates a column when
+// its slot is reused.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vmath.h"
+
+typedef enum {
+    KERNEL_LINEAR = 0,
+    KERNEL_POLY,
+    KERNEL_RBF,
+    KERNEL_COUNT
+} KernelKind;
+
+const char *KERNEL_NAMES[KERNEL_COUNT] = {"linear", "poly", "rbf"};
+
+typedef struct {
+    KernelKind kind;
+    float gamma;    // rbf width, poly scale
+    float coef0;    // poly offset
+    int degree;     // poly degree
+} Kernel;
+
+// K(a, b) where b's elements are `b_stride` floats apart (1 for a plain
+// row, the column capacity for a column-major set).
+float kernel_eval_strided(const Kernel *k, const float *a, const float *b, size_t b_stride,
+                          int dim) {
+    switch (k->kind) {
+        case KERNEL_RBF: {
+            float d2 = 0;
+            for (int j = 0; j < dim; j++) {
+                float d = a[j] - b[j * b_stride];
+                d2 += d * d;
+            }
+            return expf(-k->gamma * d2);
+        }
+        case KERNEL_POLY: {
+            float dot = 0;
+            for (int j = 0; j < dim; j++) dot += a[j] * b[j * b_stride];
+            float base = k->gamma * dot + k->coef0, r = 1.0f;
+            for (int p = 0; p < k->degree; p++) r *= base;
+            return r;
+        }
+        default: {
+            float dot = 0;
+            for (int j = 0; j < dim; j++) dot += a[j] * b[j * b_stride];
+            return dot;
+        }
+    }
+}
+
+float kernel_eval(const Kernel *k, const float *a, const float *b, int dim) {
+    return kernel_eval_strided(k, a, b, 1, dim);
+}
+
+// K(x, v_j) for the first `count` vectors of a column-major set with
+// `cap` slots per column (cap a multiple of 4). Writes up to count
+// rounded up to 4; the padding lanes are computed from whatever the
+// columns hold there.
+void kernel_row(const Kernel *k, const float *x, const float *cols, int cap, int count,
+                int dim, float *out) {
+    int j = 0;
+#if defined(__SSE2__)
+    __m128 gamma = _mm_set1_ps(k->gamma);
+    for (; j < count; j += 4) {
+        __m128 acc = _mm_setzero_ps();
+        for (int d = 0; d < dim; d++) {
+            __m128 v = _mm_loadu_ps(cols + (size_t)d * cap + j);
+            __m128 xd = _mm_set1_ps(x[d]);
+            if (k->kind == KERNEL_RBF) {
+                __m128 diff = _mm_sub_ps(v, xd);
+                acc = _mm_add_ps(acc, _mm_mul_ps(diff, diff));
+            } else {
+                acc = _mm_add_ps(acc, _mm_mul_ps(v, xd));
+            }
+        }
+        if (k->kind == KERNEL_RBF) {
+            acc = exp_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(gamma, acc)));
+        } else if (k->kind == KERNEL_POLY) {
+            __m128 base = _mm_add_ps(_mm_mul_ps(gamma, acc), _mm_set1_ps(k->coef0));
+            acc = _mm_set1_ps(1.0f);
+            for (int p = 0; p < k->degree; p++) acc = _mm_mul_ps(acc, base);
+        }
+        _mm_storeu_ps(out + j, acc);
+    }
+#endif
+    for (; j < count; j++)
+        out[j] = kernel_eval_strided(k, x, cols + j, cap, dim);
+}
+
+// ── Budgeted kernel perceptron ──────────────────────────────
+
+typedef enum {
+    BUDGET_OLDEST = 0,   // evict the earliest inserted vector
+    BUDGET_SMALLEST,     // evict the vector with the smallest |alpha|
+    BUDGET_POLICY_COUNT
+} BudgetPolicy;
+
+const char *BUDGET_POLICY_NAMES[BUDGET_POLICY_COUNT] = {"oldest", "smallest"};
+
+typedef struct {
+    Kernel kernel;
+    int dim;
+    int budget;
+    int cap;                // budget rounded up to 4
+    BudgetPolicy policy;
+
+    float *sv;              // dim columns of cap values
+    float *alpha;           // signed coefficients, 0 in unused slots
+    int *src;               // dataset row of each vector, -1 for streamed ones
+    long long *born;        // insertion order, for BUDGET_OLDEST
+    unsigned *slot_gen;     // bumped whenever a slot is overwritten
+    int count;
+
+    long long inserted;
+    long long evicted;
+    long long mistakes;
+    float *krow;            // scratch kernel row, cap values
+} KernelPerceptron;
+
+typedef struct {
+    int rows;
+    int cap;
+    float *values;          // rows x cap
+    unsigned *stamp;        // slot_gen a value was computed against
+    long long hits;
+    long long misses;
+} KernelCache;
+
+void kperc_init(KernelPerceptron *kp, Kernel kernel, int dim, int budget, BudgetPolicy policy) {
+    *kp = (KernelPerceptron){0};
+    kp->kernel = kernel;
+    kp->dim = dim;
+    kp->budget = budget > 0 ? budget : 1;
+    kp->cap = (kp->budget + 3) & ~3;
+    kp->policy = policy;
+    kp->sv = calloc((size_t)dim * kp->cap, sizeof(float));
+    kp->alpha = calloc(kp->cap, sizeof(float));
+    kp->src = malloc(sizeof(int) * kp->cap);
+    kp->born = calloc(kp->cap, sizeof(long long));
+    kp->slot_gen = malloc(sizeof(unsigned) * kp->cap);
+    kp->krow = calloc(kp->cap, sizeof(float));
+    for (int j = 0; j < kp->cap; j++) {
+        kp->src[j] = -1;
+        kp->slot_gen[j] = 1;
+    }
+}
+
+void kperc_free(KernelPerceptron *kp) {
+    free(kp->sv);
+    free(kp->alpha);
+    free(kp->src);
+    free(kp->born);
+    free(kp->slot_gen);
+    free(kp->krow);
+    *kp = (KernelPerceptron){0};
+}
+
+void kcache_init(KernelCache *c, int rows, const KernelPerceptron *kp) {
+    *c = (KernelCache){0};
+    c->rows = rows;
+    c->cap = kp->cap;
+    c->values = malloc(sizeof(float) * (size_t)rows * c->cap);
+    c->stamp = calloc((size_t)rows * c->cap, sizeof(unsigned));  // 0 never matches
+}
+
+void kcache_free(KernelCache *c) {
+    free(c->values);
+    free(c->stamp);
+    *c = (KernelCache){0};
+}
+
+float kperc_dot_alpha(const KernelPerceptron *kp) {
+    int j = 0;
+    float sum = 0;
+#if defined(__SSE2__)
+    __m128 acc = _mm_setzero_ps();
+    for (; j + 4 <= kp->count; j += 4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(kp->alpha + j), _mm_loadu_ps(kp->krow + j)));
+    sum = hsum_ps(acc);
+#endif
+    for (; j < kp->count; j++) sum += kp->alpha[j] * kp->krow[j];
+    return sum;
+}
+
+// f(x) = sum_j alpha_j K(x, v_j); the sign is the class.
+float kperc_decision(KernelPerceptron *kp, const float *x) {
+    if (kp->count == 0) return 0.0f;
+    kernel_row(&kp->kernel, x, kp->sv, kp->cap, kp->count, kp->dim, kp->krow);
+    return kperc_dot_alpha(kp);
+}
+
+// Same as kperc_decision() for dataset row `row`, reusing cached kernel
+// values for slots that have not changed since they were computed.
+float kperc_decision_cached(KernelPerceptron *kp, KernelCache *c, const float *x, int row) {
+    float *values = c->values + (size_t)row * c->cap;
+    unsigned *stamp = c->stamp + (size_t)row * c->cap;
+    for (int j = 0; j < kp->count; j++) {
+        if (stamp[j] == kp->slot_gen[j]) {
+            kp->krow[j] = values[j];
+            c->hits++;
+            continue;
+        }
+        values[j] = kp->krow[j] = kernel_eval_strided(&kp->kernel, x, kp->sv + j, kp->cap,
+                                                      kp->dim);
+        stamp[j] = kp->slot_gen[j];
+        c->misses++;
+    }
+    return kperc_dot_alpha(kp);
+}
+
+int kperc_pick_victim(const KernelPerceptron *kp) {
+    int victim = 0;
+    for (int j = 1; j < kp->count; j++) {
+        if (kp->policy == BUDGET_SMALLEST ? fabsf(kp->alpha[j]) < fabsf(kp->alpha[victim])
+                                          : kp->born[j] < kp->born[victim])
+            victim = j;
+    }
+    return victim;
+}
+
+void kperc_add(KernelPerceptron *kp, const float *x, float y, int src) {
+    if (src >= 0) {
+        for (int j = 0; j < kp->count; j++) {
+            if (kp->src[j] == src) {
+                kp->alpha[j] += y;
+                return;
+            }
+        }
+    }
+
+    int slot;
+    if (kp->count < kp->budget) {
+        slot = kp->count++;
+    } else {
+        slot = kperc_pick_victim(kp);
+        kp->evicted++;
+    }
+    for (int d = 0; d < kp->dim; d++) kp->sv[(size_t)d * kp->cap + slot] = x[d];
+    kp->alpha[slot] = y;
+    kp->src[slot] = src;
+    kp->born[slot] = kp->inserted++;
+    kp->slot_gen[slot]++;
+}
+
+// One online step with label y in {-1, +1}. Returns true on a mistake.
+// `src` identifies the dataset row (with `cache` optional), or is -1 for
+// streamed samples.
+bool kperc_train_sample(KernelPerceptron *kp, const float *x, int y, int src, KernelCache *cache) {
+    float f = (cache && src >= 0) ? kperc_decision_cached(kp, cache, x, src)
+                                  : kperc_decision(kp, x);
+    if (y * f > 0) return false;
+    kp->mistakes++;
+    kperc_add(kp, x, (float)y, src);
+    return true;
+}
+
+// One pass over n row-major samples; returns the number of mistakes.
+int kperc_train_epoch(KernelPerceptron *kp, const float *X, const int *y, int n,
+                      KernelCache *cache) {
+    int mistakes = 0;
+    for (int i = 0; i < n; i++)
+        mistakes += kperc_train_sample(kp, X + (size_t)i * kp->dim, y[i], i, cache);
+    return mistakes;
+}
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef MULTICLASS_H
+#define MULTICLASS_H
+
+// Multiclass linear SVM from binary dcd.h models. Include pool.h and dcd.h
+// first.
+//
+// One-vs-rest trains one model per class (that class +1, the rest -1) and
+// predicts the class with the highest score. One-vs-one trains a model per
+// pair of classes on just their samples and predicts by majority vote,
+// ties going to the larger summed margin.
+//
+// The binary problems are independent, so multi_train() runs them as pool
+// tasks. They all read the same row-major feature matrix; each task only
+// writes its own labels, solver state and row of `w`.
+
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    MULTI_OVR = 0,
+    MULTI_OVO,
+    MULTI_MODE_COUNT
+} MultiMode;
+
+const char *MULTI_MODE_NAMES[MULTI_MODE_COUNT] = {"one-vs-rest", "one-vs-one"};
+
+typedef struct {
+    MultiMode mode;
+    int classes;
+    int dim;
+    int models;             // classes for OVR, classes (classes - 1) / 2 for OVO
+    DcdLoss loss;
+    double C;
+
+    float *w;               // models rows of dim weights, then the bias
+    int *pos, *neg;         // classes each model separates; neg is -1 for OVR
+    int *passes;            // DCD passes per model
+} MultiSvm;
+
+void multi_init(MultiSvm *m, MultiMode mode, int classes, int dim, DcdLoss loss, double C) {
+    *m = (MultiSvm){0};
+    m->mode = mode;
+    m->classes = classes;
+    m->dim = dim;
+    m->loss = loss;
+    m->C = C;
+    m->models = mode == MULTI_OVR ? classes : classes * (classes - 1) / 2;
+    m->w = calloc((size_t)m->models * (dim + 1), sizeof(float));
+    m->pos = malloc(sizeof(int) * m->models);
+    m->neg = malloc(sizeof(int) * m->models);
+    m->passes = calloc(m->models, sizeof(int));
+
+    int k = 0;
+    for (int a = 0; a < classes; a++) {
+        if (mode == MULTI_OVR) {
+            m->pos[k] = a;
+            m->neg[k++] = -1;
+            continue;
+        }
+        for (int b = a + 1; b < classes; b++) {
+            m->pos[k] = a;
+            m->neg[k++] = b;
+        }
+    }
+}
+
+void multi_free(MultiSvm *m) {
+    free(m->w);
+    free(m->pos);
+    free(m->neg);
+    free(m->passes);
+    *m = (MultiSvm){0};
+}
+
+typedef struct {
+    MultiSvm *m;
+    const float *X;         // shared, read-only
+    const int *labels;      // 0 .. classes - 1
+    int n;
+} MultiTrainCtx;
+
+void multi_train_task(void *ctx, int task, int worker) {
+    (void)worker;
+    MultiTrainCtx *c = ctx;
+    MultiSvm *m = c->m;
+    int dim = m->dim, pos = m->pos[task], neg = m->neg[task];
+
+    // OVR trains on the shared matrix as is; OVO gathers its two classes
+    const float *X = c->X;
+    float *subset = NULL;
+    int *y = malloc(sizeof(int) * (c->n > 0 ? c->n : 1));
+    int count = 0;
+    if (neg < 0) {
+        for (int i = 0; i < c->n; i++) y[i] = c->labels[i] == pos ? 1 : -1;
+        count = c->n;
+    } else {
+        subset = malloc(sizeof(float) * (size_t)(c->n > 0 ? c->n : 1) * dim);
+        for (int i = 0; i < c->n; i++) {
+            if (c->labels[i] != pos && c->labels[i] != neg) continue;
+            memcpy(subset + (size_t)count * dim, c->X + (size_t)i * dim, sizeof(float) * dim);
+            y[count++] = c->labels[i] == pos ? 1 : -1;
+        }
+        X = subset;
+    }
+
+    DcdSvm s;
+    dcd_init(&s, count, dim, m->loss, m->C);
+    dcd_train(&s, X, y);
+    memcpy(m->w + (size_t)task * (dim + 1), s.w, sizeof(float) * (dim + 1));
+    m->passes[task] = s.passes;
+    dcd_free(&s);
+    free(subset);
+    free(y);
+}
+
+// Trains every binary model, one pool task each. `pool` may be NULL to
+// train them one after another on the calling thread.
+void multi_train(MultiSvm *m, const float *X, const int *labels, int n, ThreadPool *pool) {
+    MultiTrainCtx ctx = {m, X, labels, n};
+    if (pool) {
+        pool_run(pool, multi_train_task, &ctx, m->models);
+    } else {
+        for (int t = 0; t < m->models; t++) multi_train_task(&ctx, t, 0);
+    }
+}
+
+// Class of one row. `score` (optional) gets the winning model score for
+// OVR, or the winner's summed margin for OVO.
+int multi_predict(const MultiSvm *m, const float *x, float *score) {
+    int dim = m->dim;
+    int best = 0;
+    float best_score = -FLT_MAX;
+    int votes[m->classes > 0 ? m->classes : 1];
+    float margin[m->classes > 0 ? m->classes : 1];
+    if (m->mode == MULTI_OVO) {
+        memset(votes, 0, sizeof(votes));
+        memset(margin, 0, sizeof(margin));
+    }
+
+    for (int k = 0; k < m->models; k++) {
+        const float *w = m->w + (size_t)k * (dim + 1);
+        float f = w[dim];
+        for (int d = 0; d < dim; d++) f += w[d] * x[d];
+        if (m->mode == MULTI_OVR) {
+            if (f > best_score) {
+                best_score = f;
+                best = k;
+            }
+        } else {
+            int winner = f >= 0 ? m->pos[k] : m->neg[k];
+            votes[winner]++;
+            margin[m->pos[k]] += f;
+            margin[m->neg[k]] -= f;
+        }
+    }
+
+    if (m->mode == MULTI_OVO) {
+        for (int c = 0; c < m->classes; c++) {
+            if (votes[c] > votes[best] || (votes[c] == votes[best] && margin[c] > margin[best]))
+                best = c;
+        }
+        best_score = margin[best];
+    }
+    if (score) *score = best_score;
+    return best;
+}
+
+// Classes of n rows in one pass: each row is scored against every model
+// and reduced to its argmax before moving on. Returns the number of rows
+// that match `labels` when it is given.
+int multi_predict_batch(const MultiSvm *m, const float *X, int n, int *out,
+                        const int *labels) {
+    int correct = 0;
+    for (int i = 0; i < n; i++) {
+        int c = multi_predict(m, X + (size_t)i * m->dim, NULL);
+        if (out) out[i] = c;
+        if (labels) correct += c == labels[i];
+    }
+    return correct;
+}
+
+#endif
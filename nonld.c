@@ -9,6 +9,12 @@
 #define NOB_IMPLEMENTATION
 #include "nob.h"
 #include "anim.h"
+#include "kernel.h"
+#include "smo.h"
+#include "svmodel.h"
+#include "dcd.h"
+#include "vmath.h"
+#include "rff.h"
 
 #if defined(PLATFORM_WEB)
 #include <emscripten.h>
@@ -280,6 +286,321 @@ void prepare_kernel_dataset(Dataset *td) {
     }
 }
 
+/* ─── decision heat maps ─── */
+
+/* The 2D classifier views sample their decision function on a
+   HEAT_GRID x HEAT_GRID grid of cells covering [-HEAT_EXTENT, HEAT_EXTENT]^2
+   and shade each cell by its sign. */
+
+#define HEAT_GRID        48
+#define HEAT_EXTENT      6.0f
+
+void draw_decision_grid(const float *grid) {
+    float cell = 2.0f * HEAT_EXTENT / HEAT_GRID;
+    for (int iz = 0; iz < HEAT_GRID; iz++) {
+        for (int ix = 0; ix < HEAT_GRID; ix++) {
+            float f = grid[iz * HEAT_GRID + ix];
+            Color c = f > 0 ? COLOR_BLUE : COLOR_RED;
+            c.a = 35;
+            Vector3 center = {-HEAT_EXTENT + (ix + 0.5f) * cell, -0.01f,
+                              -HEAT_EXTENT + (iz + 0.5f) * cell};
+            DrawPlane(center, (Vector2){cell, cell}, c);
+        }
+    }
+}
+
+/* ─── budgeted kernel perceptron ─── */
+
+/* Learns the circles directly in the flat (x, z) plane with an RBF kernel,
+   one epoch per frame, keeping at most kperc_budgets[i] support vectors. */
+
+#define KPERC_MAX_EPOCHS 200
+
+int kperc_budgets[] = {4, 8, 16, 32, 64};
+int kperc_budget_idx = 3;
+KernelPerceptron kperc   = {0};
+KernelCache kcache       = {0};
+float *kperc_X           = NULL;
+int   *kperc_y           = NULL;
+bool  kperc_on           = false;
+bool  kperc_done         = false;
+int   kperc_epoch        = 0;
+int   kperc_mistakes     = 0;
+float kperc_grid[HEAT_GRID * HEAT_GRID];
+
+void kperc_update_grid(void) {
+    float cell = 2.0f * HEAT_EXTENT / HEAT_GRID;
+    for (int iz = 0; iz < HEAT_GRID; iz++) {
+        for (int ix = 0; ix < HEAT_GRID; ix++) {
+            float p[2] = {-HEAT_EXTENT + (ix + 0.5f) * cell, -HEAT_EXTENT + (iz + 0.5f) * cell};
+            kperc_grid[iz * HEAT_GRID + ix] = kperc_decision(&kperc, p);
+        }
+    }
+}
+
+void kperc_start(const Dataset *ds) {
+    int n = (int)ds->count;
+    kperc_X = realloc(kperc_X, sizeof(float) * 2 * n);
+    kperc_y = realloc(kperc_y, sizeof(int) * n);
+    for (int i = 0; i < n; i++) {
+        kperc_X[2 * i]     = ds->items[i].x;
+        kperc_X[2 * i + 1] = ds->items[i].z;
+        kperc_y[i] = ds->items[i].label == CLASS_INNER ? 1 : -1;
+    }
+
+    kcache_free(&kcache);
+    kperc_free(&kperc);
+    Kernel rbf = {.kind = KERNEL_RBF, .gamma = 0.5f};
+    kperc_init(&kperc, rbf, 2, kperc_budgets[kperc_budget_idx], BUDGET_SMALLEST);
+    kcache_init(&kcache, n, &kperc);
+
+    kperc_on = true;
+    kperc_done = false;
+    kperc_epoch = 0;
+    kperc_mistakes = n;
+    kperc_update_grid();
+}
+
+void classify_by_kperc(Dataset *ds) {
+    for (size_t i = 0; i < ds->count; i++) {
+        float f = kperc_decision(&kperc, &kperc_X[2 * i]);
+        Color target = f > 0 ? COLOR_BLUE : COLOR_RED;
+        tween_color(&te, &ds->items[i].vis.color, WHITE, 0.2f);
+        Tween *tc = tween_color(&te, &ds->items[i].vis.color, target, 0.6f);
+        if (tc) tc->elapsed = -0.3f;
+    }
+}
+
+/* One epoch per frame until an epoch makes no mistakes. */
+void kperc_update(Dataset *ds) {
+    if (!kperc_on || kperc_done) return;
+    kperc_mistakes = kperc_train_epoch(&kperc, kperc_X, kperc_y, (int)ds->count, &kcache);
+    kperc_epoch++;
+    kperc_update_grid();
+    if (kperc_mistakes == 0 || kperc_epoch >= KPERC_MAX_EPOCHS) {
+        kperc_done = true;
+        classify_by_kperc(ds);
+    }
+}
+
+void draw_kperc_boundary(void) {
+    if (!kperc_on || view_mode != VIEW_2D) return;
+    draw_decision_grid(kperc_grid);
+}
+
+void draw_kperc_support_vectors(const Dataset *ds) {
+    if (!kperc_on) return;
+    for (int j = 0; j < kperc.count; j++) {
+        int i = kperc.src[j];
+        if (i < 0 || i >= (int)ds->count) continue;
+        Vector3 pos = ds->items[i].vis.pos;
+        if (view_mode == VIEW_2D) pos.y = 0;
+        DrawSphereWires(pos, ds->items[i].vis.radius * 2.2f, 6, 6, YELLOW);
+    }
+}
+
+void draw_kperc_status(void) {
+    if (!kperc_on) return;
+    char buf[128];
+    snprintf(buf, sizeof(buf), "KERNEL PERCEPTRON (rbf): %d/%d SVs, epoch %d, %d mistakes%s",
+             kperc.count, kperc.budget, kperc_epoch, kperc_mistakes,
+             kperc_done ? (kperc_mistakes == 0 ? " - separated" : " - stopped") : "");
+    DrawText(buf, 20, HEIGHT - 76, 24, kperc_done && kperc_mistakes == 0 ? COLOR_GREEN : YELLOW);
+
+    long long lookups = kcache.hits + kcache.misses;
+    snprintf(buf, sizeof(buf), "kernel cache hit rate %.0f%%, %lld evictions",
+             lookups ? 100.0 * kcache.hits / lookups : 0.0, kperc.evicted);
+    DrawText(buf, 20, HEIGHT - 104, 20, GRAY);
+}
+
+/* ─── kernel SVM ─── */
+
+/* Soft-margin RBF SVM on the same flat points, solved by SMO a few
+   iterations per frame so the boundary can be watched settling. Kernel
+   rows come from the solver's LRU cache, capped at KSVM_CACHE_BYTES. Once
+   it converges the support vectors are compacted (svmodel.h) and the final
+   grid and point colors come from the compact model in one batch. */
+
+#define KSVM_STEPS_PER_FRAME 20
+#define KSVM_CACHE_BYTES     (64 << 10)
+#define KSVM_C               10.0
+
+SmoSolver ksvm        = {0};
+float *ksvm_X         = NULL;
+int   *ksvm_y         = NULL;   /* the solver keeps a pointer to the labels */
+bool  ksvm_on         = false;
+bool  ksvm_done       = false;
+float ksvm_grid[HEAT_GRID * HEAT_GRID];
+SvModel ksvm_model    = {0};
+
+void ksvm_update_grid(void) {
+    static float points[2 * HEAT_GRID * HEAT_GRID];
+    float cell = 2.0f * HEAT_EXTENT / HEAT_GRID;
+    for (int iz = 0; iz < HEAT_GRID; iz++) {
+        for (int ix = 0; ix < HEAT_GRID; ix++) {
+            float *p = &points[2 * (iz * HEAT_GRID + ix)];
+            p[0] = -HEAT_EXTENT + (ix + 0.5f) * cell;
+            p[1] = -HEAT_EXTENT + (iz + 0.5f) * cell;
+            if (!ksvm_done) ksvm_grid[iz * HEAT_GRID + ix] = (float)smo_decision(&ksvm, p);
+        }
+    }
+    if (ksvm_done) svmodel_predict_batch(&ksvm_model, points, HEAT_GRID * HEAT_GRID, ksvm_grid);
+}
+
+void ksvm_start(const Dataset *ds) {
+    int n = (int)ds->count;
+    ksvm_X = realloc(ksvm_X, sizeof(float) * 2 * n);
+    ksvm_y = realloc(ksvm_y, sizeof(int) * n);
+    for (int i = 0; i < n; i++) {
+        ksvm_X[2 * i]     = ds->items[i].x;
+        ksvm_X[2 * i + 1] = ds->items[i].z;
+        ksvm_y[i] = ds->items[i].label == CLASS_INNER ? 1 : -1;
+    }
+
+    smo_free(&ksvm);
+    Kernel rbf = {.kind = KERNEL_RBF, .gamma = 0.5f};
+    smo_init(&ksvm, ksvm_X, ksvm_y, n, 2, rbf, KSVM_C);
+    smo_set_cache_bytes(&ksvm, KSVM_CACHE_BYTES);
+    ksvm_on = true;
+    ksvm_done = false;
+    ksvm_update_grid();
+}
+
+void classify_by_ksvm(Dataset *ds) {
+    float *f = malloc(sizeof(float) * (ds->count > 0 ? ds->count : 1));
+    svmodel_predict_batch(&ksvm_model, ksvm_X, (int)ds->count, f);
+    for (size_t i = 0; i < ds->count; i++) {
+        Color target = f[i] > 0 ? COLOR_BLUE : COLOR_RED;
+        tween_color(&te, &ds->items[i].vis.color, WHITE, 0.2f);
+        Tween *tc = tween_color(&te, &ds->items[i].vis.color, target, 0.6f);
+        if (tc) tc->elapsed = -0.3f;
+    }
+    free(f);
+}
+
+void ksvm_update(Dataset *ds) {
+    if (!ksvm_on || ksvm_done) return;
+    ksvm_done = smo_run(&ksvm, KSVM_STEPS_PER_FRAME) || ksvm.iter >= ksvm.max_iter;
+    if (ksvm_done) {
+        svmodel_free(&ksvm_model);
+        svmodel_compact(&ksvm_model, &ksvm);
+        classify_by_ksvm(ds);
+    }
+    ksvm_update_grid();
+}
+
+void draw_ksvm_boundary(void) {
+    if (!ksvm_on || view_mode != VIEW_2D) return;
+    draw_decision_grid(ksvm_grid);
+}
+
+void draw_ksvm_support_vectors(const Dataset *ds) {
+    if (!ksvm_on) return;
+    for (int i = 0; i < ksvm.n && i < (int)ds->count; i++) {
+        if (ksvm.alpha[i] <= 0) continue;
+        Vector3 pos = ds->items[i].vis.pos;
+        if (view_mode == VIEW_2D) pos.y = 0;
+        Color c = ksvm.alpha[i] < ksvm.C ? YELLOW : ORANGE;
+        DrawSphereWires(pos, ds->items[i].vis.radius * 2.2f, 6, 6, c);
+    }
+}
+
+void draw_ksvm_status(void) {
+    if (!ksvm_on) return;
+    int bounded;
+    int sv = smo_support_count(&ksvm, &bounded);
+    char buf[160];
+    snprintf(buf, sizeof(buf), "KERNEL SVM (rbf, C = %g): %d SVs (%d at C), iteration %lld, KKT gap %.2e%s",
+             ksvm.C, sv, bounded, ksvm.iter, ksvm.gap, ksvm.converged ? " - optimal" : "");
+    DrawText(buf, 20, HEIGHT - 76, 24, ksvm.converged ? COLOR_GREEN : YELLOW);
+
+    long long lookups = ksvm.cache_hits + ksvm.rows_computed;
+    snprintf(buf, sizeof(buf), "row cache %d/%d rows, hit rate %.0f%%, %lld rows computed",
+             ksvm.cached, ksvm.cache_rows, lookups ? 100.0 * ksvm.cache_hits / lookups : 0.0,
+             ksvm.rows_computed);
+    if (ksvm_done)
+        snprintf(buf + strlen(buf), sizeof(buf) - strlen(buf), " | compact model %d/%d vectors, %.1f KB",
+                 ksvm_model.count, ksvm.n, svmodel_bytes(&ksvm_model) / 1024.0);
+    DrawText(buf, 20, HEIGHT - 104, 20, GRAY);
+}
+
+/* ─── random Fourier features ─── */
+
+/* The same RBF kernel approximated by RFF_FEATURES random cosine features,
+   with a linear SVM (dcd.h) trained on them in one go. The whole decision
+   grid goes through rff_transform() as a single batch. */
+
+#define RFF_FEATURES 256
+#define RFF_C        10.0
+
+RffMap rff            = {0};
+DcdSvm rff_svm        = {0};
+bool  rff_on          = false;
+float rff_grid[HEAT_GRID * HEAT_GRID];
+double rff_ms         = 0;
+
+void rff_update_grid(void) {
+    static float points[2 * HEAT_GRID * HEAT_GRID];
+    float cell = 2.0f * HEAT_EXTENT / HEAT_GRID;
+    for (int iz = 0; iz < HEAT_GRID; iz++) {
+        for (int ix = 0; ix < HEAT_GRID; ix++) {
+            points[2 * (iz * HEAT_GRID + ix)]     = -HEAT_EXTENT + (ix + 0.5f) * cell;
+            points[2 * (iz * HEAT_GRID + ix) + 1] = -HEAT_EXTENT + (iz + 0.5f) * cell;
+        }
+    }
+    float *Z = malloc(sizeof(float) * HEAT_GRID * HEAT_GRID * RFF_FEATURES);
+    rff_transform(&rff, points, HEAT_GRID * HEAT_GRID, Z);
+    for (int k = 0; k < HEAT_GRID * HEAT_GRID; k++)
+        rff_grid[k] = dcd_decision(&rff_svm, Z + (size_t)k * RFF_FEATURES);
+    free(Z);
+}
+
+void rff_start(Dataset *ds) {
+    int n = (int)ds->count;
+    float *X = malloc(sizeof(float) * 2 * n);
+    int *y = malloc(sizeof(int) * n);
+    for (int i = 0; i < n; i++) {
+        X[2 * i]     = ds->items[i].x;
+        X[2 * i + 1] = ds->items[i].z;
+        y[i] = ds->items[i].label == CLASS_INNER ? 1 : -1;
+    }
+
+    double t0 = GetTime();
+    rff_free(&rff);
+    rff_init(&rff, 2, RFF_FEATURES, 0.5f, (uint32_t)rand() + 1);
+    float *Z = malloc(sizeof(float) * (size_t)n * RFF_FEATURES);
+    rff_transform(&rff, X, n, Z);
+    dcd_free(&rff_svm);
+    dcd_init(&rff_svm, n, RFF_FEATURES, DCD_L1_LOSS, RFF_C);
+    dcd_train(&rff_svm, Z, y);
+    rff_ms = (GetTime() - t0) * 1000.0;
+
+    for (int i = 0; i < n; i++) {
+        float f = dcd_decision(&rff_svm, Z + (size_t)i * RFF_FEATURES);
+        Color target = f > 0 ? COLOR_BLUE : COLOR_RED;
+        tween_color(&te, &ds->items[i].vis.color, WHITE, 0.2f);
+        Tween *tc = tween_color(&te, &ds->items[i].vis.color, target, 0.6f);
+        if (tc) tc->elapsed = -0.3f;
+    }
+    rff_update_grid();
+    rff_on = true;
+    free(Z);
+    free(X);
+    free(y);
+}
+
+void draw_rff_boundary(void) {
+    if (!rff_on || view_mode != VIEW_2D) return;
+    draw_decision_grid(rff_grid);
+}
+
+void draw_rff_status(void) {
+    if (!rff_on) return;
+    char buf[160];
+    snprintf(buf, sizeof(buf), "RANDOM FEATURES (rbf, D = %d, C = %g): linear SVM, %d passes, %.1f ms%s",
+             rff.out, rff_svm.C, rff_svm.passes, rff_ms, rff_svm.converged ? " - optimal" : "");
+    DrawText(buf, 20, HEIGHT - 76, 24, rff_svm.converged ? COLOR_GREEN : YELLOW);
+}
 
 void cam_look_at(Camera *cam, Vector3 target) {
     tween_vec3(&te, &cam->target, target, 1);
@@ -363,6 +684,10 @@ void draw_controls(void) {
     DrawText("K - kernel trick (lift / flatten)",         x, y + lh * i++, fs, GRAY);
     DrawText("Q - separating plane (needs kernel)",       x, y + lh * i++, fs, GRAY);
     DrawText("T - toggle 2D / 3D view",                  x, y + lh * i++, fs, GRAY);
+    DrawText("P - kernel perceptron (train / hide)",      x, y + lh * i++, fs, GRAY);
+    DrawText("B - cycle support vector budget",           x, y + lh * i++, fs, GRAY);
+    DrawText("V - kernel SVM via SMO (solve / hide)",     x, y + lh * i++, fs, GRAY);
+    DrawText("F - random Fourier features + linear SVM",  x, y + lh * i++, fs, GRAY);
     DrawText("2D: Mouse Wheel - zoom",                    x, y + lh * i++, fs, GRAY);
     DrawText("3D: Free camera - WASD / Mouse",            x, y + lh * i++, fs, GRAY);
 }
@@ -400,6 +725,43 @@ void update_frame(void) {
     if (IsKeyPressed(KEY_Q))
         toggle_separating_plane(&training_set);
 
+    if (IsKeyPressed(KEY_P)) {
+        if (kperc_on) {
+            kperc_on = false;
+            restore_original_colors(&training_set);
+        } else {
+            ksvm_on = false;
+            rff_on = false;
+            kperc_start(&training_set);
+        }
+    }
+    if (IsKeyPressed(KEY_V)) {
+        if (ksvm_on) {
+            ksvm_on = false;
+            restore_original_colors(&training_set);
+        } else {
+            kperc_on = false;
+            rff_on = false;
+            ksvm_start(&training_set);
+        }
+    }
+    if (IsKeyPressed(KEY_F)) {
+        if (rff_on) {
+            rff_on = false;
+            restore_original_colors(&training_set);
+        } else {
+            kperc_on = false;
+            ksvm_on = false;
+            rff_start(&training_set);
+        }
+    }
+    if (IsKeyPressed(KEY_B)) {
+        kperc_budget_idx = (kperc_budget_idx + 1) % (int)(sizeof(kperc_budgets) / sizeof(kperc_budgets[0]));
+        if (kperc_on) kperc_start(&training_set);
+    }
+    kperc_update(&training_set);
+    ksvm_update(&training_set);
+
 
     BeginDrawing();
     ClearBackground(BACKGROUND_COLOR);
@@ -411,13 +773,21 @@ void update_frame(void) {
 
     draw_axes(view_mode);
     draw_separating_plane();
+    draw_kperc_boundary();
+    draw_ksvm_boundary();
+    draw_rff_boundary();
     draw_dataset(&training_set, true);
+    draw_kperc_support_vectors(&training_set);
+    draw_ksvm_support_vectors(&training_set);
 
     EndMode3D();
 
     draw_axis_labels(&camera, view_mode);
     draw_controls();
     draw_kernel_status();
+    draw_kperc_status();
+    draw_ksvm_status();
+    draw_rff_status();
     draw_classes();
 
     EndDrawing();
@@ -463,6 +833,16 @@ int main(void) {
     }
 #endif
 
+    kcache_free(&kcache);
+    kperc_free(&kperc);
+    free(kperc_X);
+    free(kperc_y);
+    smo_free(&ksvm);
+    free(ksvm_X);
+    free(ksvm_y);
+    svmodel_free(&ksvm_model);
+    rff_free(&rff);
+    dcd_free(&rff_svm);
     CloseWindow();
     return 0;
 }
@@ -0,0 +1,241 @@
+#ifndef NYSTROM_H
+#define NYSTROM_H
+
+// Nyström approximation of a kernel from m landmark points L:
+//
+//     z(x) = K_mm^{-1/2} k(x),   k(x)_j = K(x, l_j)
+//
+// so z(x) . z(y) = k(x)' K_mm^+ k(y), which is exact whenever x or y is a
+// landmark. A linear model on z stands in for the kernel machine, as with
+// rff.h, but the features adapt to where the data is. Include kernel.h
+// first.
+//
+// Landmarks are drawn uniformly without replacement, or by k-means++ (each
+// next one with probability proportional to its squared distance to the
+// nearest one already chosen), which spreads them over the data. K_mm^{-1/2}
+// comes from a cyclic Jacobi eigendecomposition, computed once; eigenvalues
+// below NYSTROM_RCOND times the largest are dropped (a pseudo-inverse).
+//
+// Landmarks are stored column-major like KernelPerceptron's vectors, so
+// kernel_row() produces k(x) four landmarks at a time. nystrom_transform()
+// works on NYSTROM_BLOCK rows at a time: their kernel rows first, then the
+// product with K_mm^{-1/2} walking its rows in the outer loop, so each row
+// is loaded once per block instead of once per input.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NYSTROM_BLOCK 64
+#define NYSTROM_RCOND 1e-6
+
+typedef enum {
+    NYSTROM_UNIFORM = 0,
+    NYSTROM_KMEANSPP,
+    NYSTROM_SAMPLING_COUNT
+} NystromSampling;
+
+const char *NYSTROM_SAMPLING_NAMES[NYSTROM_SAMPLING_COUNT] = {"uniform", "k-means++"};
+
+typedef struct {
+    Kernel kernel;
+    int dim;
+    int m;                  // landmarks, and output features
+    int cap;                // m rounded up to 4
+    float *landmarks;       // dim columns of cap values
+    float *proj;            // K_mm^{-1/2}, m rows of cap values
+    int rank;               // eigenvalues kept
+    int sweeps;             // Jacobi sweeps taken
+    float *scratch;         // NYSTROM_BLOCK rows of cap kernel values
+} NystromMap;
+
+uint32_t nystrom_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Indices of m landmarks among n row-major samples.
+void nystrom_pick(const float *X, int n, int dim, int m, NystromSampling sampling,
+                  uint32_t seed, int *picked) {
+    uint32_t state = seed ? seed : 1;
+    if (sampling == NYSTROM_UNIFORM) {
+        // Partial Fisher-Yates
+        int *order = malloc(sizeof(int) * n);
+        for (int i = 0; i < n; i++) order[i] = i;
+        for (int k = 0; k < m; k++) {
+            int r = k + (int)(nystrom_rand(&state) % (uint32_t)(n - k));
+            int tmp = order[k];
+            order[k] = order[r];
+            order[r] = tmp;
+            picked[k] = order[k];
+        }
+        free(order);
+        return;
+    }
+
+    float *d2 = malloc(sizeof(float) * n);
+    for (int i = 0; i < n; i++) d2[i] = INFINITY;
+    picked[0] = (int)(nystrom_rand(&state) % (uint32_t)n);
+    for (int k = 1; k < m; k++) {
+        const float *last = X + (size_t)picked[k - 1] * dim;
+        double total = 0;
+        for (int i = 0; i < n; i++) {
+            const float *x = X + (size_t)i * dim;
+            float d = 0;
+            for (int j = 0; j < dim; j++) d += (x[j] - last[j]) * (x[j] - last[j]);
+            if (d < d2[i]) d2[i] = d;
+            total += d2[i];
+        }
+        double target = (nystrom_rand(&state) >> 8) / 16777216.0 * total;
+        int next = n - 1;
+        for (int i = 0; i < n; i++) {
+            target -= d2[i];
+            if (target < 0) {
+                next = i;
+                break;
+            }
+        }
+        picked[k] = next;
+    }
+    free(d2);
+}
+
+// Eigenvalues of the symmetric m x m matrix A (destroyed; its diagonal ends
+// up holding them) and eigenvectors in the columns of V. Returns the number
+// of sweeps.
+int nystrom_jacobi(double *A, double *V, int m) {
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < m; j++) V[i * m + j] = i == j;
+
+    int sweep = 0;
+    for (; sweep < 50; sweep++) {
+        double off = 0, diag = 0;
+        for (int i = 0; i < m; i++) {
+            diag += A[i * m + i] * A[i * m + i];
+            for (int j = i + 1; j < m; j++) off += A[i * m + j] * A[i * m + j];
+        }
+        if (off <= 1e-24 * diag) break;
+
+        for (int p = 0; p < m; p++) {
+            for (int q = p + 1; q < m; q++) {
+                double apq = A[p * m + q];
+                if (fabs(apq) < 1e-300) continue;
+                double theta = (A[q * m + q] - A[p * m + p]) / (2 * apq);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1));
+                double c = 1 / sqrt(t * t + 1), s = t * c;
+                for (int k = 0; k < m; k++) {
+                    double akp = A[k * m + p], akq = A[k * m + q];
+                    A[k * m + p] = c * akp - s * akq;
+                    A[k * m + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < m; k++) {
+                    double apk = A[p * m + k], aqk = A[q * m + k];
+                    A[p * m + k] = c * apk - s * aqk;
+                    A[q * m + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < m; k++) {
+                    double vkp = V[k * m + p], vkq = V[k * m + q];
+                    V[k * m + p] = c * vkp - s * vkq;
+                    V[k * m + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    return sweep;
+}
+
+// Picks m landmarks from n row-major samples and factors K_mm.
+void nystrom_init(NystromMap *nm, Kernel kernel, const float *X, int n, int dim, int m,
+                  NystromSampling sampling, uint32_t seed) {
+    *nm = (NystromMap){0};
+    if (m > n) m = n;
+    nm->kernel = kernel;
+    nm->dim = dim;
+    nm->m = m;
+    nm->cap = (m + 3) & ~3;
+    nm->landmarks = calloc((size_t)dim * nm->cap, sizeof(float));
+    nm->proj = calloc((size_t)m * nm->cap, sizeof(float));
+    nm->scratch = malloc(sizeof(float) * NYSTROM_BLOCK * nm->cap);
+
+    int *picked = malloc(sizeof(int) * m);
+    nystrom_pick(X, n, dim, m, sampling, seed, picked);
+    for (int j = 0; j < m; j++)
+        for (int d = 0; d < dim; d++)
+            nm->landmarks[(size_t)d * nm->cap + j] = X[(size_t)picked[j] * dim + d];
+
+    double *A = malloc(sizeof(double) * m * m);
+    double *V = malloc(sizeof(double) * m * m);
+    for (int i = 0; i < m; i++) {
+        for (int j = i; j < m; j++) {
+            A[i * m + j] = A[j * m + i] = kernel_eval(&kernel, X + (size_t)picked[i] * dim,
+                                                      X + (size_t)picked[j] * dim, dim);
+        }
+    }
+    nm->sweeps = nystrom_jacobi(A, V, m);
+
+    double top = 0;
+    for (int k = 0; k < m; k++)
+        if (A[k * m + k] > top) top = A[k * m + k];
+
+    // K^{-1/2} = V diag(1 / sqrt(lambda)) V', over the kept eigenvalues
+    double *acc = calloc((size_t)m * m, sizeof(double));
+    for (int k = 0; k < m; k++) {
+        double lambda = A[k * m + k];
+        if (lambda <= NYSTROM_RCOND * top) continue;
+        nm->rank++;
+        double w = 1 / sqrt(lambda);
+        for (int i = 0; i < m; i++) {
+            double vi = V[i * m + k] * w;
+            for (int j = 0; j < m; j++) acc[i * m + j] += vi * V[j * m + k];
+        }
+    }
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < m; j++) nm->proj[(size_t)i * nm->cap + j] = (float)acc[i * m + j];
+
+    free(acc);
+    free(A);
+    free(V);
+    free(picked);
+}
+
+void nystrom_free(NystromMap *nm) {
+    free(nm->landmarks);
+    free(nm->proj);
+    free(nm->scratch);
+    *nm = (NystromMap){0};
+}
+
+// Maps n row-major inputs to n rows of nm->m features in Z.
+void nystrom_transform(NystromMap *nm, const float *X, int n, float *Z) {
+    int m = nm->m, cap = nm->cap;
+    for (int start = 0; start < n; start += NYSTROM_BLOCK) {
+        int rows = start + NYSTROM_BLOCK <= n ? NYSTROM_BLOCK : n - start;
+        for (int r = 0; r < rows; r++)
+            kernel_row(&nm->kernel, X + (size_t)(start + r) * nm->dim, nm->landmarks, cap, m,
+                       nm->dim, nm->scratch + (size_t)r * cap);
+
+        float *out = Z + (size_t)start * m;
+        memset(out, 0, sizeof(float) * (size_t)rows * m);
+        for (int k = 0; k < m; k++) {
+            const float *p = nm->proj + (size_t)k * cap;
+            for (int r = 0; r < rows; r++) {
+                float c = nm->scratch[(size_t)r * cap + k];
+                float *z = out + (size_t)r * m;
+                int j = 0;
+#if defined(__SSE2__)
+                __m128 cv = _mm_set1_ps(c);
+                for (; j + 4 <= m; j += 4)
+                    _mm_storeu_ps(z + j, _mm_add_ps(_mm_loadu_ps(z + j),
+                                                    _mm_mul_ps(cv, _mm_loadu_ps(p + j))));
+#endif
+                for (; j < m; j++) z[j] += c * p[j];
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef PEGASOS_H
+#define PEGASOS_H
+
+// Mini-batch Pegasos (Shalev-Shwartz et al. 2007) for the linear SVM
+//
+//     min  lambda/2 |w|^2 + 1/n sum max(0, 1 - y_i (w.x_i + b))
+//
+// Step t takes k samples, finds those with margin < 1 and moves
+//
+//     w <- (1 - eta lambda) w + eta/k sum y_i x_i,   eta = 1 / (lambda t)
+//
+// then optionally projects w onto the ball |w| <= 1/sqrt(lambda), which
+// holds the optimum. Setting `t0` starts the schedule at eta =
+// 1 / (lambda (t0 + 1)) instead: with a small lambda the first plain steps
+// are huge and the 1/t decay takes thousands of steps to undo them. The
+// bias is left unregularized and follows the same step. An epoch walks a
+// fresh permutation in batches of k.
+//
+// Margins are dot products along the feature axis four at a time; the
+// violators' y_i x_i are summed the same way. Each batch is split into
+// chunks of PEGASOS_CHUNK rows, each with its own scratch gradient, and
+// the chunks are summed in order before the step. The split depends only
+// on the batch size, so a pooled run gives bit-for-bit the same result as
+// a serial one whatever the thread count. Include pool.h and vmath.h first.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PEGASOS_CHUNK 256
+
+typedef struct {
+    int dim;
+    int stride;             // dim rounded up to 4, the scratch row length
+    float lambda;
+    int batch;
+    bool project;
+
+    float *w;
+    float b;
+    long long t;            // steps taken
+    float t0;               // schedule offset, 0 for plain Pegasos
+    int epochs;
+    uint32_t rng;
+
+    int *order;             // permutation of the current epoch
+    int order_len;
+    int chunks;             // scratch rows allocated
+    float *grad;            // chunks rows of stride values, then bias sums
+    int *violators;         // per chunk
+} Pegasos;
+
+void pegasos_init(Pegasos *pg, int dim, float lambda, int batch, bool project) {
+    *pg = (Pegasos){0};
+    pg->dim = dim;
+    pg->stride = (dim + 3) & ~3;
+    pg->lambda = lambda;
+    pg->batch = batch > 0 ? batch : 1;
+    pg->project = project;
+    pg->w = calloc(dim > 0 ? dim : 1, sizeof(float));
+    pg->rng = 0x2545f491u;
+}
+
+void pegasos_free(Pegasos *pg) {
+    free(pg->w);
+    free(pg->order);
+    free(pg->grad);
+    free(pg->violators);
+    *pg = (Pegasos){0};
+}
+
+float pegasos_dot(const float *a, const float *b, int dim) {
+    int d = 0;
+    float sum = 0;
+#if defined(__SSE2__)
+    __m128 acc = _mm_setzero_ps();
+    for (; d + 4 <= dim; d += 4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + d), _mm_loadu_ps(b + d)));
+    sum = hsum_ps(acc);
+#endif
+    for (; d < dim; d++) sum += a[d] * b[d];
+    return sum;
+}
+
+// out += scale * x
+void pegasos_axpy(float *out, const float *x, float scale, int dim) {
+    int d = 0;
+#if defined(__SSE2__)
+    __m128 s = _mm_set1_ps(scale);
+    for (; d + 4 <= dim; d += 4)
+        _mm_storeu_ps(out + d, _mm_add_ps(_mm_loadu_ps(out + d),
+                                          _mm_mul_ps(s, _mm_loadu_ps(x + d))));
+#endif
+    for (; d < dim; d++) out[d] += scale * x[d];
+}
+
+float pegasos_decision(const Pegasos *pg, const float *x) {
+    return pegasos_dot(pg->w, x, pg->dim) + pg->b;
+}
+
+typedef struct {
+    Pegasos *pg;
+    const float *X;
+    const int *y;
+    const int *rows;        // the batch, as dataset rows
+    int count;
+    int chunks;
+} PegasosBatch;
+
+void pegasos_chunk_task(void *ctx, int task, int worker) {
+    (void)worker;
+    PegasosBatch *c = ctx;
+    Pegasos *pg = c->pg;
+    float *g = pg->grad + (size_t)task * pg->stride;
+    memset(g, 0, sizeof(float) * pg->stride);
+    int begin = task * PEGASOS_CHUNK;
+    int end = begin + PEGASOS_CHUNK < c->count ? begin + PEGASOS_CHUNK : c->count;
+    float gb = 0;
+    int violators = 0;
+    for (int k = begin; k < end; k++) {
+        int i = c->rows[k];
+        const float *x = c->X + (size_t)i * pg->dim;
+        float yi = (float)c->y[i];
+        if (yi * pegasos_decision(pg, x) < 1.0f) {
+            pegasos_axpy(g, x, yi, pg->dim);
+            gb += yi;
+            violators++;
+        }
+    }
+    pg->grad[(size_t)c->chunks * pg->stride + task] = gb;
+    pg->violators[task] = violators;
+}
+
+// One step on `count` dataset rows. Returns how many were violators.
+int pegasos_step(Pegasos *pg, const float *X, const int *y, const int *rows, int count,
+                 ThreadPool *pool) {
+    int chunks = (count + PEGASOS_CHUNK - 1) / PEGASOS_CHUNK;
+    if (chunks > pg->chunks) {
+        pg->chunks = chunks;
+        pg->grad = realloc(pg->grad, sizeof(float) * ((size_t)chunks * pg->stride + chunks));
+        pg->violators = realloc(pg->violators, sizeof(int) * chunks);
+    }
+
+    // A single chunk is not worth waking the workers for
+    PegasosBatch ctx = {pg, X, y, rows, count, chunks};
+    if (pool && chunks > 1) {
+        pool_run(pool, pegasos_chunk_task, &ctx, chunks);
+    } else {
+        for (int k = 0; k < chunks; k++) pegasos_chunk_task(&ctx, k, 0);
+    }
+
+    float *g = pg->grad;
+    float gb = pg->grad[(size_t)chunks * pg->stride];
+    int violators = pg->violators[0];
+    for (int k = 1; k < chunks; k++) {
+        pegasos_axpy(g, pg->grad + (size_t)k * pg->stride, 1.0f, pg->dim);
+        gb += pg->grad[(size_t)chunks * pg->stride + k];
+        violators += pg->violators[k];
+    }
+
+    pg->t++;
+    float eta = 1.0f / (pg->lambda * (pg->t0 + (float)pg->t));
+    float shrink = 1.0f - eta * pg->lambda;
+    for (int d = 0; d < pg->dim; d++) pg->w[d] *= shrink;
+    pegasos_axpy(pg->w, g, eta / count, pg->dim);
+    pg->b += eta / count * gb;
+
+    if (pg->project) {
+        float norm = sqrtf(pegasos_dot(pg->w, pg->w, pg->dim));
+        float radius = 1.0f / sqrtf(pg->lambda);
+        if (norm > radius) {
+            float scale = radius / norm;
+            for (int d = 0; d < pg->dim; d++) pg->w[d] *= scale;
+        }
+    }
+    return violators;
+}
+
+// One pass over n row-major samples in batches of pg->batch. `pool` may be
+// NULL. Returns the number of margin violators seen.
+int pegasos_epoch(Pegasos *pg, const float *X, const int *y, int n, ThreadPool *pool) {
+    if (n <= 0) return 0;
+    if (pg->order_len != n) {
+        pg->order = realloc(pg->order, sizeof(int) * n);
+        pg->order_len = n;
+        for (int i = 0; i < n; i++) pg->order[i] = i;
+    }
+    for (int i = n - 1; i > 0; i--) {
+        pg->rng ^= pg->rng << 13;
+        pg->rng ^= pg->rng >> 17;
+        pg->rng ^= pg->rng << 5;
+        int j = (int)(pg->rng % (uint32_t)(i + 1));
+        int tmp = pg->order[i];
+        pg->order[i] = pg->order[j];
+        pg->order[j] = tmp;
+    }
+
+    int violators = 0;
+    for (int start = 0; start < n; start += pg->batch) {
+        int count = start + pg->batch <= n ? pg->batch : n - start;
+        violators += pegasos_step(pg, X, y, pg->order + start, count, pool);
+    }
+    pg->epochs++;
+    return violators;
+}
+
+// lambda/2 |w|^2 + mean hinge
+double pegasos_objective(const Pegasos *pg, const float *X, const int *y, int n) {
+    double hinge = 0;
+    for (int i = 0; i < n; i++) {
+        float h = 1.0f - y[i] * pegasos_decision(pg, X + (size_t)i * pg->dim);
+        if (h > 0) hinge += h;
+    }
+    return 0.5 * pg->lambda * pegasos_dot(pg->w, pg->w, pg->dim) + (n ? hinge / n : 0);
+}
+
+#endif
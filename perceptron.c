@@ -7,6 +7,11 @@
 
 #define NOB_IMPLEMENTATION
 #include "nob.h"
+#include "perceptron.h"
+#include "converge.h"
+#include "pool.h"
+#include "hogwild.h"
+#include "trajectory.h"
 
 #include "anim.h"
 #if defined(PLATFORM_WEB)
@@ -28,131 +33,227 @@
 #define COLOR_BORDER     (Color){26, 32, 48, 255}
 #define COLOR_DIM        (Color){110, 122, 138, 255}
 
-float lr = 0.1f;
 TweenEngine te;
+Perceptron perceptron = {0};
+Optimizer opt;
+ConvergeMonitor monitor;
+ThreadPool pool;
+ParallelMode par_mode = PAR_SERIAL;
+Datasets datasets = {0};
+int current_dataset = 0;
 
-// ── Perceptron ──────────────────────────────────────────────
+// ── Grid predictor ──────────────────────────────────────────
 
-typedef struct {
-    float *w;
-    int num_weights;
-    float b;
-} Perceptron;
+#define SIGMOID_LUT_SIZE  4096
+#define SIGMOID_LUT_RANGE 16.0f
 
-float activation_fn(float sum) {
-    return 1.0f / (1.0f + expf(-sum));
-}
+unsigned char sigmoid_lut[SIGMOID_LUT_SIZE];
+bool sigmoid_lut_ready = false;
 
-float predict(const Perceptron *p, float *inputs) {
-    float sum = 0;
-    for (int j = 0; j < p->num_weights; j++)
-        sum += p->w[j] * inputs[j];
-    sum += p->b;
-    return activation_fn(sum);
+void init_sigmoid_lut(void) {
+    for (int i = 0; i < SIGMOID_LUT_SIZE; i++) {
+        float z = ((float)i / (SIGMOID_LUT_SIZE - 1)) * 2.0f * SIGMOID_LUT_RANGE
+                  - SIGMOID_LUT_RANGE;
+        sigmoid_lut[i] = (unsigned char)(activation_fn(z) * 255.0f + 0.5f);
+    }
+    sigmoid_lut_ready = true;
 }
 
-void init_perceptron(Perceptron *p, int input_size) {
-    p->w = malloc(sizeof(float) * input_size);
-    p->num_weights = input_size;
-    p->b = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-    for (int i = 0; i < input_size; i++)
-        p->w[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+// Evaluates the perceptron over a cols x rows grid spanning the first two
+// inputs' bounds (row 0 is the top, like the screen), other inputs held at
+// 0, and writes outputs as 0..255. The pre-activation is separable, so each
+// row is base + step * ix.
+void predict_grid(const Perceptron *p, const float lo[2], const float hi[2],
+                  int cols, int rows, unsigned char *out) {
+    if (!sigmoid_lut_ready) init_sigmoid_lut();
+
+    float w0 = p->num_weights > 0 ? p->w[0] : 0.0f;
+    float w1 = p->num_weights > 1 ? p->w[1] : 0.0f;
+    float x_step = cols > 1 ? w0 * (hi[0] - lo[0]) / (float)(cols - 1) : 0.0f;
+    float lut_scale = (SIGMOID_LUT_SIZE - 1) / (2.0f * SIGMOID_LUT_RANGE);
+
+    for (int iy = 0; iy < rows; iy++) {
+        float y_t = rows > 1 ? 1.0f - (float)iy / (rows - 1) : 0.0f;
+        float y_in = lo[1] + (hi[1] - lo[1]) * y_t;
+        float base = (p->b + w0 * lo[0] + w1 * y_in + SIGMOID_LUT_RANGE) * lut_scale;
+        float step = x_step * lut_scale;
+        unsigned char *row = out + (size_t)iy * cols;
+        for (int ix = 0; ix < cols; ix++) {
+            int k = (int)(base + step * (float)ix);
+            if (k < 0) k = 0;
+            if (k > SIGMOID_LUT_SIZE - 1) k = SIGMOID_LUT_SIZE - 1;
+            row[ix] = sigmoid_lut[k];
+        }
+    }
 }
 
-void reset_perceptron(Perceptron *p) {
-    p->b = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-    for (int i = 0; i < p->num_weights; i++)
-        p->w[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-}
+// ── Error history ───────────────────────────────────────────
 
-void train_step(Perceptron *p, int sample_count, int input_count,
-                float dataset[][input_count], float *mse) {
-    float total_error = 0;
-    for (int i = 0; i < sample_count; i++) {
-        float *data = dataset[i];
-        float expected = data[input_count - 1];
-        float sum = p->b;
-        for (int j = 0; j < input_count - 1; j++)
-            sum += p->w[j] * data[j];
-        float output = activation_fn(sum);
-        float error = output - expected;
-        total_error += error * error;
-        for (int j = 0; j < input_count - 1; j++)
-            p->w[j] -= lr * error * data[j];
-        p->b -= lr * error;
-    }
-    *mse = total_error / (float)sample_count;
-}
+// Every epoch's MSE goes into a min/max pyramid: level l holds buckets that
+// each summarize 2^l consecutive epochs, in a fixed-size ring. Pushing is
+// O(1) amortized and the chart reads one level, so a whole run of millions
+// of epochs fits in bounded memory.
 
-// ── Datasets ────────────────────────────────────────────────
+#define ERROR_HISTORY_LEVELS 32
+#define ERROR_HISTORY_CAP    1024
 
-float AND_Dataset[4][3] = {
-    {0, 0, 0}, {0, 1, 0}, {1, 0, 0}, {1, 1, 1}
-};
-float OR_Dataset[4][3] = {
-    {0, 0, 0}, {0, 1, 1}, {1, 0, 1}, {1, 1, 1}
-};
-float NAND_Dataset[4][3] = {
-    {0, 0, 1}, {0, 1, 1}, {1, 0, 1}, {1, 1, 0}
-};
-float XOR_Dataset[4][3] = {
-    {0, 0, 0}, {0, 1, 1}, {1, 0, 1}, {1, 1, 0}
-};
+typedef struct {
+    float min, max;
+} ErrorBucket;
 
 typedef struct {
-    const char *name;
-    float (*data)[3];
-    int count;
-} DatasetInfo;
-
-DatasetInfo datasets[] = {
-    {"AND",  AND_Dataset,  4},
-    {"OR",   OR_Dataset,   4},
-    {"NAND", NAND_Dataset, 4},
-    {"XOR",  XOR_Dataset,  4},
-};
-int num_datasets = 4;
-int current_dataset = 0;
+    ErrorBucket buckets[ERROR_HISTORY_CAP];
+    int head;            // next slot to write
+    int count;           // valid buckets, <= ERROR_HISTORY_CAP
+    ErrorBucket pending; // half-built bucket for the level above
+    int pending_n;
+} ErrorLevel;
 
-// ── Error history ───────────────────────────────────────────
+typedef struct {
+    ErrorLevel levels[ERROR_HISTORY_LEVELS];
+    long long total;
+    float last;
+} ErrorHistory;
 
-#define ERROR_HISTORY_MAX 500
-float error_history[ERROR_HISTORY_MAX] = {0};
-int error_history_count = 0;
+ErrorHistory error_history = {0};
 
 void push_error(float e) {
-    if (error_history_count < ERROR_HISTORY_MAX) {
-        error_history[error_history_count++] = e;
-    } else {
-        memmove(error_history, error_history + 1, (ERROR_HISTORY_MAX - 1) * sizeof(float));
-        error_history[ERROR_HISTORY_MAX - 1] = e;
+    ErrorHistory *h = &error_history;
+    ErrorBucket bk = {e, e};
+    h->total++;
+    h->last = e;
+
+    for (int l = 0; l < ERROR_HISTORY_LEVELS; l++) {
+        ErrorLevel *lv = &h->levels[l];
+        lv->buckets[lv->head] = bk;
+        lv->head = (lv->head + 1) % ERROR_HISTORY_CAP;
+        if (lv->count < ERROR_HISTORY_CAP) lv->count++;
+
+        if (lv->pending_n == 0) {
+            lv->pending = bk;
+            lv->pending_n = 1;
+            break;
+        }
+        bk.min = fminf(lv->pending.min, bk.min);
+        bk.max = fmaxf(lv->pending.max, bk.max);
+        lv->pending_n = 0;
     }
 }
 
+// Picks the finest level whose whole span fits in max_buckets.
+int error_history_level(int max_buckets) {
+    if (max_buckets > ERROR_HISTORY_CAP) max_buckets = ERROR_HISTORY_CAP;
+    for (int l = 0; l < ERROR_HISTORY_LEVELS; l++)
+        if ((error_history.total >> l) <= max_buckets) return l;
+    return ERROR_HISTORY_LEVELS - 1;
+}
+
+// i-th oldest bucket still held by level l.
+ErrorBucket error_history_at(int l, int i) {
+    const ErrorLevel *lv = &error_history.levels[l];
+    int idx = (lv->head - lv->count + i + ERROR_HISTORY_CAP) % ERROR_HISTORY_CAP;
+    return lv->buckets[idx];
+}
+
 void reset_error_history(void) {
-    error_history_count = 0;
-    memset(error_history, 0, sizeof(error_history));
+    memset(&error_history, 0, sizeof(error_history));
 }
 
-// ── Weight history (for animation) ─────────────────────────
+// ── Epoch scheduler ─────────────────────────────────────────
+
+// Sizes epochs_per_frame so training fills train_budget_ms of each frame:
+// the measured per-epoch cost is smoothed and the next batch is sized from
+// it, growing at most 2x per frame so a stall cannot overshoot.
+
+#define FRAME_BUDGET_MS      (1000.0f / 60.0f)
+#define MAX_EPOCHS_PER_FRAME 1000000
 
 typedef struct {
-    float w0, w1, b;
-} WeightSnapshot;
+    float train_budget_ms;  // slice of the frame given to training
+    int epochs_per_frame;
+    double epoch_cost_ms;   // smoothed cost of one epoch
+    double epochs_per_sec;  // smoothed throughput
+    float budget_used;      // last frame's training time / budget
+} EpochScheduler;
+
+EpochScheduler sched = {
+    .train_budget_ms = 10.0f,
+    .epochs_per_frame = 1,
+};
+
+void sched_record(EpochScheduler *s, int epochs, double elapsed_ms, float frame_dt) {
+    if (epochs <= 0) return;
+    double cost = elapsed_ms / epochs;
+    s->epoch_cost_ms = s->epoch_cost_ms > 0 ? s->epoch_cost_ms * 0.8 + cost * 0.2 : cost;
+    s->budget_used = (float)(elapsed_ms / s->train_budget_ms);
+
+    double eps = frame_dt > 0 ? epochs / frame_dt : 0;
+    s->epochs_per_sec = s->epochs_per_sec * 0.9 + eps * 0.1;
+
+    double target = s->train_budget_ms / (s->epoch_cost_ms > 1e-9 ? s->epoch_cost_ms : 1e-9);
+    if (target > s->epochs_per_frame * 2.0) target = s->epochs_per_frame * 2.0;
+    if (target < 1) target = 1;
+    if (target > MAX_EPOCHS_PER_FRAME) target = MAX_EPOCHS_PER_FRAME;
+    s->epochs_per_frame = (int)target;
+}
+
+void sched_idle(EpochScheduler *s) {
+    s->budget_used = 0;
+    s->epochs_per_sec *= 0.9;
+}
+
+// ── Weight trajectory ───────────────────────────────────────
+
+// Every epoch's weights go into a delta-packed log. Scrubbing the error
+// chart restores any of them into `replay`, which is drawn instead of the
+// live perceptron until [T] returns to it.
+
+#define TRAJ_MAX_BYTES (64u << 20)
+
+Trajectory trajectory = {0};
+Perceptron replay = {0};
+bool scrubbing = false;
+long long scrub_epoch = 0;
+Rectangle error_chart_rect = {0};
+
+void restart_trajectory(void) {
+    int n = perceptron.num_weights;
+    traj_init(&trajectory, n + 1, TRAJ_MAX_BYTES);
+    traj_record(&trajectory, perceptron.w, perceptron.b);
+    if (replay.num_weights != n) {
+        free(replay.w);
+        replay.w = calloc(n > 0 ? n : 1, sizeof(float));
+        replay.num_weights = n;
+    }
+    scrubbing = false;
+}
+
+void scrub_to(long long epoch) {
+    if (epoch > trajectory.count - 1) epoch = trajectory.count - 1;
+    if (epoch < 0) epoch = 0;
+    if (!traj_restore(&trajectory, epoch, replay.w, &replay.b)) return;
+    replay.epoch = epoch;
+    replay.version++;
+    scrub_epoch = epoch;
+    scrubbing = true;
+}
 
 
 // ── Perceptron animation state ──────────────────────────────
 
 float perc_anim_t = 0.0f;
 float pulse_t = 0.0f;
-float signal_t[2] = {0};
+#define MAX_DRAWN_INPUTS 8
+
+float signal_t[MAX_DRAWN_INPUTS] = {0};
+int drawn_inputs = 2;
 float output_signal_t = 0.0f;
 
 void start_perceptron_anim(void) {
     Tween *tw = tween_float(&te, &perc_anim_t, 1.0f, 1.5f);
     tw->ease = EASE_OUT_QUAD;
 
-    for (int i = 0; i < 2; i++) {
+    for (int i = 0; i < drawn_inputs; i++) {
         signal_t[i] = 0;
         Tween *s = tween_float(&te, &signal_t[i], 1.0f, 0.6f);
         s->ease = EASE_IN_OUT_QUAD;
@@ -171,7 +272,7 @@ void start_perceptron_anim(void) {
 }
 
 void trigger_signal_anim(void) {
-    for (int i = 0; i < 2; i++) {
+    for (int i = 0; i < drawn_inputs; i++) {
         signal_t[i] = 0;
         Tween *s = tween_float(&te, &signal_t[i], 1.0f, 0.6f);
         s->ease = EASE_IN_OUT_QUAD;
@@ -210,7 +311,7 @@ void draw_perceptron_structure(const Perceptron *p, float *inputs,
                                 int ox, int oy, int panel_w, int panel_h) {
     draw_panel(ox, oy, panel_w, panel_h, "PERCEPTRON");
 
-    int n = p->num_weights;
+    int n = p->num_weights < MAX_DRAWN_INPUTS ? p->num_weights : MAX_DRAWN_INPUTS;
 
     // Scale everything to panel size
     int pad_x = panel_w * 0.08f;
@@ -229,6 +330,10 @@ void draw_perceptron_structure(const Perceptron *p, float *inputs,
     int x_start = ox + pad_x + base_radius + 40;
     int y_center = oy + pad_y + usable_h / 2;
 
+    // Inputs share the column, so spacing and radius shrink as n grows
+    float sp = n > 1 ? fminf(spacing_y, usable_h * 0.7f / (n - 1)) : spacing_y;
+    float in_radius = fminf(base_radius, sp * 0.42f);
+
     float alpha = perc_anim_t * 255;
     if (alpha < 1) return;
 
@@ -237,15 +342,15 @@ void draw_perceptron_structure(const Perceptron *p, float *inputs,
     int font_sm  = panel_h > 500 ? 15 : 12;
 
     // ── Input nodes ──
-    Vector2 input_pos[2];
+    Vector2 input_pos[MAX_DRAWN_INPUTS];
     for (int i = 0; i < n; i++) {
-        input_pos[i] = (Vector2){x_start, y_center + (i - 0.5f) * spacing_y};
-        float r = base_radius;
+        input_pos[i] = (Vector2){x_start, y_center + (i - (n - 1) * 0.5f) * sp};
+        float r = in_radius;
 
         // Pulse on signal
         float pulse = 0;
         if (signal_t[i] > 0.01f && signal_t[i] < 0.99f)
-            pulse = sinf(signal_t[i] * PI) * base_radius * 0.15f;
+            pulse = sinf(signal_t[i] * PI) * in_radius * 0.15f;
         r += pulse;
 
         // Outer ring
@@ -259,9 +364,9 @@ void draw_perceptron_structure(const Perceptron *p, float *inputs,
             float glow_a = sinf(signal_t[i] * PI);
             Color glow = COLOR_BLUE;
             glow.a = (unsigned char)(glow_a * 60);
-            DrawCircle(input_pos[i].x, input_pos[i].y, r + base_radius * 0.3f, glow);
+            DrawCircle(input_pos[i].x, input_pos[i].y, r + in_radius * 0.3f, glow);
             glow.a = (unsigned char)(glow_a * 30);
-            DrawCircle(input_pos[i].x, input_pos[i].y, r + base_radius * 0.6f, glow);
+            DrawCircle(input_pos[i].x, input_pos[i].y, r + in_radius * 0.6f, glow);
         }
 
         // Fill subtle
@@ -271,16 +376,26 @@ void draw_perceptron_structure(const Perceptron *p, float *inputs,
 
         // Label
         char label[32];
-        snprintf(label, sizeof(label), "x%d = %.0f", i, inputs[i]);
+        snprintf(label, sizeof(label), "x%d = %.3g", i, inputs[i]);
         Color lc = COLOR_BLUE;
         lc.a = (unsigned char)alpha;
         int tw = MeasureText(label, font_med);
         DrawText(label, input_pos[i].x - tw / 2, input_pos[i].y - font_med / 2, font_med, lc);
     }
 
+    if (p->num_weights > n) {
+        char more[32];
+        snprintf(more, sizeof(more), "+%d more inputs", p->num_weights - n);
+        Color mc = COLOR_DIM;
+        mc.a = (unsigned char)alpha;
+        DrawText(more, x_start - MeasureText(more, font_sm) / 2,
+                 input_pos[n - 1].y + in_radius + 10, font_sm, mc);
+    }
+
     // ── Bias node ──
     float bias_r = base_radius * 0.7f;
-    Vector2 bias_pos = {x_start, y_center - spacing_y * 0.5f - spacing_y * 0.6f};
+    float top_y = y_center - (n - 1) * 0.5f * sp;
+    Vector2 bias_pos = {x_start, top_y - fmaxf(sp, in_radius * 2.5f) * 0.6f};
     {
         Color col = COLOR_GRAY;
         col.a = (unsigned char)alpha;
@@ -354,7 +469,7 @@ void draw_perceptron_structure(const Perceptron *p, float *inputs,
         Color c = w >= 0 ? COLOR_RED : COLOR_BLUE;
         c.a = (unsigned char)(alpha * 0.5f);
 
-        Vector2 from = {input_pos[i].x + base_radius + 2, input_pos[i].y};
+        Vector2 from = {input_pos[i].x + in_radius + 2, input_pos[i].y};
         Vector2 to = {neuron_pos.x - neuron_radius - 2, neuron_pos.y};
         Vector2 cur = {lerpf_local(from.x, to.x, perc_anim_t),
                        lerpf_local(from.y, to.y, perc_anim_t)};
@@ -469,13 +584,20 @@ void draw_error_chart(int ox, int oy, int w, int h) {
     int chart_y = oy + 38;
     int chart_w = w - pad * 2;
     int chart_h = h - 50;
+    error_chart_rect = (Rectangle){chart_x, chart_y, chart_w, chart_h};
+
+    if (error_history.total < 2) return;
 
-    if (error_history_count < 2) return;
+    int level = error_history_level(chart_w);
+    int visible = error_history.levels[level].count;
+    if (visible < 1) return;
 
     // Find max for scaling
     float max_e = 0.001f;
-    for (int i = 0; i < error_history_count; i++)
-        if (error_history[i] > max_e) max_e = error_history[i];
+    for (int i = 0; i < visible; i++) {
+        float m = error_history_at(level, i).max;
+        if (m > max_e) max_e = m;
+    }
 
     // Grid lines
     for (int i = 0; i <= 4; i++) {
@@ -487,33 +609,46 @@ void draw_error_chart(int ox, int oy, int w, int h) {
         DrawText(lbl, chart_x + 2, yy - 12, 12, COLOR_DIM);
     }
 
-    // Draw line
-    int count = error_history_count;
-    int start = count > chart_w ? count - chart_w : 0;
-    int visible = count - start;
-
-    for (int i = 1; i < visible; i++) {
-        float v0 = error_history[start + i - 1] / max_e;
-        float v1 = error_history[start + i] / max_e;
-        int x0 = chart_x + (i - 1) * chart_w / visible;
-        int x1 = chart_x + i * chart_w / visible;
-        int y0 = chart_y + chart_h - (int)(v0 * chart_h);
-        int y1 = chart_y + chart_h - (int)(v1 * chart_h);
-        DrawLine(x0, y0, x1, y1, COLOR_RED);
+    // Min/max band per bucket, line through the bucket maxima
+    Color band = COLOR_RED;
+    band.a = 90;
+    int prev_x = 0, prev_y = 0;
+    for (int i = 0; i < visible; i++) {
+        ErrorBucket bk = error_history_at(level, i);
+        int x = chart_x + (visible > 1 ? i * chart_w / (visible - 1) : 0);
+        int y_min = chart_y + chart_h - (int)(bk.min / max_e * chart_h);
+        int y_max = chart_y + chart_h - (int)(bk.max / max_e * chart_h);
+        if (y_min != y_max) DrawLine(x, y_max, x, y_min, band);
+        if (i > 0) DrawLine(prev_x, prev_y, x, y_max, COLOR_RED);
+        prev_x = x;
+        prev_y = y_max;
     }
 
-    // Current value
-    if (count > 0) {
-        char cur[32];
-        snprintf(cur, sizeof(cur), "%.6f", error_history[count - 1]);
-        DrawText(cur, chart_x + chart_w - 100, chart_y + 4, 14, COLOR_YELLOW);
+    // Current value and covered span
+    char cur[32];
+    snprintf(cur, sizeof(cur), "%.6f", error_history.last);
+    DrawText(cur, chart_x + chart_w - 100, chart_y + 4, 14, COLOR_YELLOW);
+
+    char span[48];
+    snprintf(span, sizeof(span), "%lld epochs, 1:%lld", error_history.total, 1LL << level);
+    DrawText(span, chart_x + chart_w - MeasureText(span, 12), chart_y + chart_h - 14, 12, COLOR_DIM);
+
+    if (scrubbing) {
+        int x = chart_x + (int)((double)scrub_epoch / error_history.total * chart_w);
+        DrawLine(x, chart_y, x, chart_y + chart_h, COLOR_YELLOW);
+        char rbuf[32];
+        snprintf(rbuf, sizeof(rbuf), "replay %lld", scrub_epoch);
+        int tx = x + 4 + MeasureText(rbuf, 12) > chart_x + chart_w ? x - 4 - MeasureText(rbuf, 12) : x + 4;
+        DrawText(rbuf, tx, chart_y + 4, 12, COLOR_YELLOW);
     }
 }
 
 // ── Draw: Prediction table ──────────────────────────────────
 
-void draw_prediction_table(const Perceptron *p, float dataset[][3],
-                           int count, int ox, int oy, int w, int h) {
+#define PREDICTION_TABLE_MAX_ROWS 64
+
+void draw_prediction_table(const Perceptron *p, const DatasetInfo *ds,
+                           int ox, int oy, int w, int h) {
     draw_panel(ox, oy, w, h, "PREDICTIONS");
 
     int row_h = 28;
@@ -522,28 +657,37 @@ void draw_prediction_table(const Perceptron *p, float dataset[][3],
 
     // Header
     DrawText("x0", ox + 10, y, 16, COLOR_DIM);
-    DrawText("x1", ox + col_w, y, 16, COLOR_DIM);
+    if (ds->dim > 1) DrawText(ds->dim > 2 ? "x1.." : "x1", ox + col_w, y, 16, COLOR_DIM);
     DrawText("exp", ox + col_w * 2, y, 16, COLOR_DIM);
     DrawText("out", ox + col_w * 3, y, 16, COLOR_DIM);
     y += row_h;
     DrawLine(ox, y - 4, ox + w, y - 4, COLOR_BORDER);
 
+    int max_rows = (oy + h - y) / row_h;
+    int count = ds->count < max_rows ? ds->count : max_rows;
+    if (count > PREDICTION_TABLE_MAX_ROWS) count = PREDICTION_TABLE_MAX_ROWS;
+    if (count < 0) count = 0;
+
+    // Visible rows are contiguous, so they are scored in one batch
+    float outputs[PREDICTION_TABLE_MAX_ROWS];
+    predict_batch(p, ds->data, ds->stride, count, outputs);
+
     for (int i = 0; i < count; i++) {
-        float inp[2] = {dataset[i][0], dataset[i][1]};
-        float expected = dataset[i][2];
-        float out = predict(p, inp);
+        const float *inp = dataset_row(ds, i);
+        float expected = dataset_label(ds, i);
+        float out = outputs[i];
         float err = fabsf(out - expected);
 
-        char b0[8], b1[8], be[8], bo[8];
-        snprintf(b0, sizeof(b0), "%.0f", inp[0]);
-        snprintf(b1, sizeof(b1), "%.0f", inp[1]);
+        char b0[16], b1[16], be[16], bo[16];
+        snprintf(b0, sizeof(b0), "%.3g", inp[0]);
+        snprintf(b1, sizeof(b1), "%.3g", ds->dim > 1 ? inp[1] : 0.0f);
         snprintf(be, sizeof(be), "%.0f", expected);
         snprintf(bo, sizeof(bo), "%.2f", out);
 
         Color row_col = err > 0.3f ? COLOR_RED : COLOR_GREEN;
 
         DrawText(b0, ox + 10, y, 16, COLOR_DIM);
-        DrawText(b1, ox + col_w, y, 16, COLOR_DIM);
+        if (ds->dim > 1) DrawText(b1, ox + col_w, y, 16, COLOR_DIM);
         DrawText(be, ox + col_w * 2, y, 16, WHITE);
         DrawText(bo, ox + col_w * 3, y, 16, row_col);
 
@@ -553,9 +697,45 @@ void draw_prediction_table(const Perceptron *p, float dataset[][3],
 
 // ── Draw: Heatmap matrix ────────────────────────────────────
 
-#define HEATMAP_RES 32
+// Prediction space is baked into a grayscale texture at panel resolution
+// and re-uploaded only when the perceptron's version changes.
+Texture2D heatmap_tex = {0};
+unsigned char *heatmap_pixels = NULL;
+const Perceptron *heatmap_owner = NULL;
+unsigned int heatmap_version = 0;
+bool heatmap_valid = false;
+
+void update_heatmap_texture(const Perceptron *p, const DatasetInfo *ds, int w, int h) {
+    if (w < 1 || h < 1) return;
+
+    if (heatmap_tex.id == 0 || heatmap_tex.width != w || heatmap_tex.height != h) {
+        if (heatmap_tex.id != 0) UnloadTexture(heatmap_tex);
+        heatmap_pixels = realloc(heatmap_pixels, (size_t)w * h);
+        memset(heatmap_pixels, 0, (size_t)w * h);
+        Image img = {
+            .data = heatmap_pixels,
+            .width = w,
+            .height = h,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE,
+        };
+        heatmap_tex = LoadTextureFromImage(img);
+        heatmap_valid = false;
+    }
+
+    if (heatmap_valid && heatmap_owner == p && heatmap_version == p->version) return;
 
-void draw_heatmap(const Perceptron *p, int ox, int oy, int w, int h) {
+    predict_grid(p, ds->lo, ds->hi, w, h, heatmap_pixels);
+    UpdateTexture(heatmap_tex, heatmap_pixels);
+    heatmap_owner = p;
+    heatmap_version = p->version;
+    heatmap_valid = true;
+}
+
+#define HEATMAP_MAX_POINTS 512
+
+void draw_heatmap(const Perceptron *p, const DatasetInfo *ds,
+                  int ox, int oy, int w, int h) {
     draw_panel(ox, oy, w, h, "PREDICTION SPACE");
 
     int pad = 12;
@@ -564,38 +744,29 @@ void draw_heatmap(const Perceptron *p, int ox, int oy, int w, int h) {
     int map_w = w - pad * 2 - 30;
     int map_h = h - 60;
 
-    float cell_w = (float)map_w / HEATMAP_RES;
-    float cell_h = (float)map_h / HEATMAP_RES;
-
-    for (int iy = 0; iy < HEATMAP_RES; iy++) {
-        for (int ix = 0; ix < HEATMAP_RES; ix++) {
-            float x_in = (float)ix / (HEATMAP_RES - 1);
-            float y_in = 1.0f - (float)iy / (HEATMAP_RES - 1);
-            float inp[2] = {x_in, y_in};
-            float out = predict(p, inp);
-
-            unsigned char v = (unsigned char)(out * 255);
-            Color c = {v, v, v, 255};
-            DrawRectangle(map_x + (int)(ix * cell_w),
-                          map_y + (int)(iy * cell_h),
-                          (int)cell_w + 1, (int)cell_h + 1, c);
-        }
-    }
+    update_heatmap_texture(p, ds, map_w, map_h);
+    DrawTexture(heatmap_tex, map_x, map_y, WHITE);
 
     // Axis labels
-    DrawText("0", map_x - 16, map_y + map_h - 10, 14, COLOR_DIM);
-    DrawText("1", map_x - 16, map_y - 2, 14, COLOR_DIM);
-    DrawText("0", map_x - 2, map_y + map_h + 4, 14, COLOR_DIM);
-    DrawText("1", map_x + map_w - 6, map_y + map_h + 4, 14, COLOR_DIM);
+    char lo0[16], hi0[16], lo1[16], hi1[16];
+    snprintf(lo0, sizeof(lo0), "%.3g", ds->lo[0]);
+    snprintf(hi0, sizeof(hi0), "%.3g", ds->hi[0]);
+    snprintf(lo1, sizeof(lo1), "%.3g", ds->lo[1]);
+    snprintf(hi1, sizeof(hi1), "%.3g", ds->hi[1]);
+    DrawText(lo1, map_x - 4 - MeasureText(lo1, 14), map_y + map_h - 10, 14, COLOR_DIM);
+    DrawText(hi1, map_x - 4 - MeasureText(hi1, 14), map_y - 2, 14, COLOR_DIM);
+    DrawText(lo0, map_x - 2, map_y + map_h + 4, 14, COLOR_DIM);
+    DrawText(hi0, map_x + map_w - MeasureText(hi0, 14), map_y + map_h + 4, 14, COLOR_DIM);
     DrawText("x0", map_x + map_w / 2 - 8, map_y + map_h + 4, 14, COLOR_DIM);
     DrawText("x1", map_x - 20, map_y + map_h / 2 - 6, 14, COLOR_DIM);
 
-    // Draw dataset points on heatmap
-    DatasetInfo *ds = &datasets[current_dataset];
-    for (int i = 0; i < ds->count; i++) {
-        float px = ds->data[i][0];
-        float py = ds->data[i][1];
-        float label = ds->data[i][2];
+    // Draw dataset points on heatmap (strided sample on large datasets)
+    int step = ds->count > HEATMAP_MAX_POINTS ? ds->count / HEATMAP_MAX_POINTS : 1;
+    for (int i = 0; i < ds->count; i += step) {
+        const float *row = dataset_row(ds, i);
+        float px = (row[0] - ds->lo[0]) / (ds->hi[0] - ds->lo[0]);
+        float py = ds->dim > 1 ? (row[1] - ds->lo[1]) / (ds->hi[1] - ds->lo[1]) : 0.5f;
+        float label = row[ds->dim];
 
         int sx = map_x + (int)(px * map_w);
         int sy = map_y + (int)((1.0f - py) * map_h);
@@ -616,7 +787,7 @@ void draw_controls(int ox, int oy, bool is_training) {
     int fs = 16;
     int gap = 22;
 
-    DrawText("[1-4]", ox, oy, fs, kc);
+    DrawText("[1-9]", ox, oy, fs, kc);
     DrawText("Select dataset", ox + 60, oy, fs, tc);
     oy += gap;
 
@@ -626,27 +797,84 @@ void draw_controls(int ox, int oy, bool is_training) {
 
     DrawText("[Q]", ox, oy, fs, kc);
     char tbuf[32];
-    snprintf(tbuf, sizeof(tbuf), "Auto-train: %s", is_training ? "ON" : "OFF");
-    DrawText(tbuf, ox + 40, oy, fs, is_training ? COLOR_GREEN : tc);
+    bool parked = is_training && monitor.state != CONV_RUNNING;
+    if (parked)
+        snprintf(tbuf, sizeof(tbuf), "Auto-train: PARKED (%s)", CONVERGE_STATE_NAMES[monitor.state]);
+    else
+        snprintf(tbuf, sizeof(tbuf), "Auto-train: %s", is_training ? "ON" : "OFF");
+    Color state_c = monitor.state == CONV_DIVERGED ? COLOR_RED : COLOR_YELLOW;
+    DrawText(tbuf, ox + 40, oy, fs, parked ? state_c : is_training ? COLOR_GREEN : tc);
+    oy += gap;
+
+    char mbuf[64];
+    snprintf(mbuf, sizeof(mbuf), "slope %.2e  |grad| %.2e", monitor.slope, monitor.grad_norm);
+    DrawText(mbuf, ox, oy, fs, tc);
     oy += gap;
 
     DrawText("[+/-]", ox, oy, fs, kc);
-    char lrbuf[32];
-    snprintf(lrbuf, sizeof(lrbuf), "LR: %.4f", lr);
+    char lrbuf[48];
+    snprintf(lrbuf, sizeof(lrbuf), "LR: %.4f (now %.4f)", opt.lr,
+             optimizer_lr(&opt, perceptron.epoch));
     DrawText(lrbuf, ox + 60, oy, fs, tc);
     oy += gap;
 
+    DrawText("[O]", ox, oy, fs, kc);
+    char obuf[32];
+    snprintf(obuf, sizeof(obuf), "Optimizer: %s", OPTIMIZER_NAMES[opt.kind]);
+    DrawText(obuf, ox + 40, oy, fs, tc);
+    oy += gap;
+
+    DrawText("[L]", ox, oy, fs, kc);
+    char sbuf[32];
+    snprintf(sbuf, sizeof(sbuf), "LR schedule: %s", LR_SCHEDULE_NAMES[opt.schedule]);
+    DrawText(sbuf, ox + 40, oy, fs, tc);
+    oy += gap;
+
+    DrawText("[H]", ox, oy, fs, kc);
+    char pbuf[64];
+    if (par_mode == PAR_SERIAL)
+        snprintf(pbuf, sizeof(pbuf), "Epochs: serial");
+    else
+        snprintf(pbuf, sizeof(pbuf), "Epochs: %s (%d threads%s)", PARALLEL_MODE_NAMES[par_mode],
+                 pool.num_threads, opt.kind == OPT_SGD ? "" : ", plain SGD");
+    DrawText(pbuf, ox + 40, oy, fs, tc);
+    oy += gap;
+
+    DrawText("[T]", ox, oy, fs, kc);
+    char tlbuf[64];
+    if (scrubbing)
+        snprintf(tlbuf, sizeof(tlbuf), "Replay: %lld/%lld (</>)", scrub_epoch, trajectory.count - 1);
+    else
+        snprintf(tlbuf, sizeof(tlbuf), "Timeline: %.1f MB%s", traj_bytes(&trajectory) / 1e6,
+                 trajectory.full ? " (full)" : "");
+    DrawText(tlbuf, ox + 40, oy, fs, scrubbing ? COLOR_YELLOW : tc);
+    oy += gap;
+
     DrawText("[R]", ox, oy, fs, kc);
     DrawText("Reset weights", ox + 40, oy, fs, tc);
+    oy += gap;
+
+    DrawText("[[/]]", ox, oy, fs, kc);
+    char bbuf[48];
+    snprintf(bbuf, sizeof(bbuf), "Budget: %.0f/%.1f ms (%.0f%%)",
+             sched.train_budget_ms, FRAME_BUDGET_MS, sched.budget_used * 100.0f);
+    DrawText(bbuf, ox + 60, oy, fs, tc);
+    oy += gap;
+
+    char ebuf[48];
+    snprintf(ebuf, sizeof(ebuf), "%.0f epochs/s  (%d/frame)",
+             sched.epochs_per_sec, sched.epochs_per_frame);
+    DrawText(ebuf, ox, oy, fs, is_training ? COLOR_GREEN : tc);
     oy += gap + 8;
 
     // Dataset indicator
     DrawText("DATASET:", ox, oy, 16, COLOR_BLUE);
     oy += 22;
-    for (int i = 0; i < num_datasets; i++) {
-        Color c = (i == current_dataset) ? COLOR_GREEN : COLOR_DIM;
-        char db[16];
-        snprintf(db, sizeof(db), "[%d] %s", i + 1, datasets[i].name);
+    for (size_t i = 0; i < datasets.count && i < 9; i++) {
+        Color c = ((int)i == current_dataset) ? COLOR_GREEN : COLOR_DIM;
+        char db[48];
+        snprintf(db, sizeof(db), "[%zu] %s (%dD, %d)", i + 1, datasets.items[i].name,
+                 datasets.items[i].dim, datasets.items[i].count);
         DrawText(db, ox, oy, 16, c);
         oy += 20;
     }
@@ -656,17 +884,25 @@ void draw_controls(int ox, int oy, bool is_training) {
 
 bool is_training_run = false;
 float current_error = 1.0f;
-Perceptron perceptron = {0};
-int epochs_per_frame = 100;
-int total_epochs = 0;
+long long total_epochs = 0;
 
 void switch_dataset(int idx) {
+    if (idx < 0 || idx >= (int)datasets.count) return;
     current_dataset = idx;
-    reset_perceptron(&perceptron);
+    const DatasetInfo *ds = &datasets.items[idx];
+    if (perceptron.num_weights != ds->dim) {
+        free(perceptron.w);
+        init_perceptron(&perceptron, ds->dim);
+        drawn_inputs = ds->dim < MAX_DRAWN_INPUTS ? ds->dim : MAX_DRAWN_INPUTS;
+    } else {
+        reset_perceptron(&perceptron);
+    }
     reset_error_history();
+    restart_trajectory();
     total_epochs = 0;
     current_error = 1.0f;
     is_training_run = false;
+    converge_resume(&monitor);
 }
 
 void update_frame(void) {
@@ -674,38 +910,108 @@ void update_frame(void) {
     tween_update(&te, dt);
 
     // Input
-    if (IsKeyPressed(KEY_ONE))   switch_dataset(0);
-    if (IsKeyPressed(KEY_TWO))   switch_dataset(1);
-    if (IsKeyPressed(KEY_THREE)) switch_dataset(2);
-    if (IsKeyPressed(KEY_FOUR))  switch_dataset(3);
+    for (int k = 0; k < 9; k++)
+        if (IsKeyPressed(KEY_ONE + k)) switch_dataset(k);
+
+    if (IsKeyPressed(KEY_Q)) {
+        is_training_run = !is_training_run;
+        scrubbing = false;
+        converge_resume(&monitor);
+    }
 
-    if (IsKeyPressed(KEY_Q)) is_training_run = !is_training_run;
+    // Timeline: drag on the error chart or step with the arrows; training
+    // stays paused while replaying
+    Vector2 mouse = GetMousePosition();
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && error_history.total > 0 &&
+        CheckCollisionPointRec(mouse, error_chart_rect)) {
+        float f = (mouse.x - error_chart_rect.x) / error_chart_rect.width;
+        scrub_to(llroundf(f * error_history.total));
+        is_training_run = false;
+    }
+    if (IsKeyPressed(KEY_T)) {
+        if (scrubbing) scrubbing = false;
+        else {
+            scrub_to(trajectory.count - 1);
+            is_training_run = false;
+        }
+    }
+    if (scrubbing) {
+        if (IsKeyPressed(KEY_LEFT) || IsKeyPressedRepeat(KEY_LEFT)) scrub_to(scrub_epoch - 1);
+        if (IsKeyPressed(KEY_RIGHT) || IsKeyPressedRepeat(KEY_RIGHT)) scrub_to(scrub_epoch + 1);
+    }
 
     if (IsKeyPressed(KEY_R)) {
         reset_perceptron(&perceptron);
         reset_error_history();
+        restart_trajectory();
         total_epochs = 0;
         current_error = 1.0f;
+        converge_resume(&monitor);
     }
 
     if (IsKeyPressed(KEY_EQUAL) || IsKeyPressed(KEY_KP_ADD)) {
-        lr *= 2.0f;
-        if (lr > 10.0f) lr = 10.0f;
+        opt.lr *= 2.0f;
+        if (opt.lr > 10.0f) opt.lr = 10.0f;
+        converge_resume(&monitor);
     }
     if (IsKeyPressed(KEY_MINUS) || IsKeyPressed(KEY_KP_SUBTRACT)) {
-        lr *= 0.5f;
-        if (lr < 0.00001f) lr = 0.00001f;
+        opt.lr *= 0.5f;
+        if (opt.lr < 0.00001f) opt.lr = 0.00001f;
+        converge_resume(&monitor);
+    }
+
+    if (IsKeyPressed(KEY_O)) {
+        LrSchedule schedule = opt.schedule;
+        opt = optimizer_default((opt.kind + 1) % OPT_COUNT);
+        opt.schedule = schedule;
+        reset_optimizer_state(&perceptron);
+        converge_resume(&monitor);
+    }
+    if (IsKeyPressed(KEY_L)) {
+        opt.schedule = (opt.schedule + 1) % LR_SCHEDULE_COUNT;
+        perceptron.epoch = 0;
+        converge_resume(&monitor);
+    }
+
+    // Parallel epochs only pay off on large (CSV) datasets
+    if (IsKeyPressed(KEY_H)) {
+        par_mode = (par_mode + 1) % PAR_MODE_COUNT;
+        converge_resume(&monitor);
+    }
+
+    if (IsKeyPressed(KEY_RIGHT_BRACKET)) {
+        sched.train_budget_ms += 1.0f;
+        if (sched.train_budget_ms > FRAME_BUDGET_MS) sched.train_budget_ms = FRAME_BUDGET_MS;
+    }
+    if (IsKeyPressed(KEY_LEFT_BRACKET)) {
+        sched.train_budget_ms -= 1.0f;
+        if (sched.train_budget_ms < 1.0f) sched.train_budget_ms = 1.0f;
     }
 
-    bool do_train = IsKeyPressed(KEY_SPACE) || is_training_run;
+    // Auto-train parks once the monitor reports convergence or divergence;
+    // any parameter change above resumes it. SPACE always steps.
+    bool do_train = IsKeyPressed(KEY_SPACE) ||
+                    (is_training_run && monitor.state == CONV_RUNNING);
     if (do_train) {
-        DatasetInfo *ds = &datasets[current_dataset];
-        for (int e = 0; e < epochs_per_frame; e++) {
-            train_step(&perceptron, ds->count, 3, ds->data, &current_error);
+        scrubbing = false;
+        const DatasetInfo *ds = &datasets.items[current_dataset];
+        int epochs = sched.epochs_per_frame;
+        int ran = 0;
+        double t0 = GetTime();
+        while (ran < epochs) {
+            train_step_parallel(&perceptron, &opt, ds, &pool, par_mode, &current_error);
+            push_error(current_error);
+            traj_record(&trajectory, perceptron.w, perceptron.b);
             total_epochs++;
+            ran++;
+            if (converge_push(&monitor, current_error) &&
+                converge_check(&monitor, gradient_norm(&perceptron, ds)) != CONV_RUNNING)
+                break;
         }
-        push_error(current_error);
+        sched_record(&sched, ran, (GetTime() - t0) * 1000.0, dt);
         trigger_signal_anim();
+    } else {
+        sched_idle(&sched);
     }
     int margin = 16;
     int top_y = margin + 36;
@@ -717,6 +1023,8 @@ void update_frame(void) {
     int col2_x = WIDTH / 2 + margin;
     int col2_w = WIDTH - col2_x - margin;
 
+    const DatasetInfo *ds = &datasets.items[current_dataset];
+
     // Update connection pulse phase
     conn_pulse_phase = fmodf(conn_pulse_phase + GetFrameTime() * 0.4f, 1.0f);
 
@@ -725,21 +1033,27 @@ void update_frame(void) {
 
     // Title bar
     char title[128];
-    snprintf(title, sizeof(title), "Perceptron — %s — Epoch: %d",
-             datasets[current_dataset].name, total_epochs);
+    if (scrubbing)
+        snprintf(title, sizeof(title), "Perceptron — %s — Epoch: %lld of %lld (replay)",
+                 ds->name, scrub_epoch, total_epochs);
+    else
+        snprintf(title, sizeof(title), "Perceptron — %s — Epoch: %lld",
+                 ds->name, total_epochs);
     DrawText(title, margin, margin, 24, WHITE);
 
-    // Col 1: Big perceptron structure (full left half)
-    float test_inputs[2] = {1, 1};
-    float test_out = predict(&perceptron, test_inputs);
-    draw_perceptron_structure(&perceptron, test_inputs, test_out,
-                              datasets[current_dataset].data[3][2],
+    // Col 1: Big perceptron structure (full left half), probed with the
+    // last sample ({1, 1} on the logic gates)
+    const Perceptron *view = scrubbing ? &replay : &perceptron;
+    float *test_inputs = dataset_row(ds, ds->count - 1);
+    float test_out = predict(view, test_inputs);
+    draw_perceptron_structure(view, test_inputs, test_out,
+                              dataset_label(ds, ds->count - 1),
                               col1_x, top_y, col1_w, content_h);
 
     // Col 2 top: Heatmap
     int heatmap_h = col2_w; // square-ish
     if (heatmap_h > content_h * 0.48f) heatmap_h = content_h * 0.48f;
-    draw_heatmap(&perceptron, col2_x, top_y, col2_w, heatmap_h);
+    draw_heatmap(view, ds, col2_x, top_y, col2_w, heatmap_h);
 
     // Col 2 mid: Error chart
     int remaining = content_h - heatmap_h - margin;
@@ -752,21 +1066,31 @@ void update_frame(void) {
     int table_w = col2_w * 0.5f;
     int ctrl_w = col2_w - table_w - margin;
 
-    draw_prediction_table(&perceptron, datasets[current_dataset].data,
-                          datasets[current_dataset].count,
-                          col2_x, bottom_y, table_w, bottom_h);
+    draw_prediction_table(view, ds, col2_x, bottom_y, table_w, bottom_h);
 
     draw_controls(col2_x + table_w + margin + 10, bottom_y + 10, is_training_run);
 
     EndDrawing();
 }
 
-int main(void) {
+int main(int argc, char **argv) {
     srand(time(NULL));
 
     te = (TweenEngine){0};
     da_reserve(&te, 1024);
-    init_perceptron(&perceptron, 2);
+
+    opt = optimizer_default(OPT_SGD);
+    converge_init(&monitor, 1e-3f, 1e-6f, 1e-5f);
+    pool_init(&pool, pool_default_threads());
+
+    // Built-in logic gates, then any CSV files given on the command line
+    add_gate_datasets(&datasets);
+    for (int i = 1; i < argc; i++) {
+        DatasetInfo ds = {0};
+        if (load_dataset_csv(argv[i], &ds)) da_append(&datasets, ds);
+    }
+    init_perceptron(&perceptron, datasets.items[0].dim);
+    restart_trajectory();
 
     InitWindow(WIDTH, HEIGHT, "Perceptron");
     SetTargetFPS(60);
@@ -781,6 +1105,11 @@ int main(void) {
         update_frame();
     }
 #endif
+    if (heatmap_tex.id != 0) UnloadTexture(heatmap_tex);
+    free(heatmap_pixels);
+    pool_free(&pool);
+    traj_free(&trajectory);
+    free(replay.w);
     CloseWindow();
     return 0;
 }
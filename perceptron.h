@@ -0,0 +1,438 @@
+#ifndef PERCEPTRON_H
+#define PERCEPTRON_H
+
+// Single-neuron perceptron model, datasets and optimizers shared by
+// perceptron.c and bench_perceptron.c. Include nob.h first.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "vmath.h"
+
+// ── Perceptron ──────────────────────────────────────────────
+
+// Optimizer state sits next to the weights: w, m and v are one allocation
+// of 3 * num_weights floats, and the bias keeps its own mb/vb slots.
+typedef struct {
+    float *w;
+    int num_weights;
+    float b;
+    unsigned int version; // bumped on every weight change, lets views cache
+
+    float *m;             // velocity / first moment, per weight
+    float *v;             // second moment (Adam), per weight
+    float mb, vb;
+    long long t;          // optimizer steps taken
+    long long epoch;      // epochs taken, drives the LR schedule
+    float beta1_t;        // beta1^t and beta2^t for Adam bias correction
+    float beta2_t;
+} Perceptron;
+
+float activation_fn(float sum) {
+    return 1.0f / (1.0f + expf(-sum));
+}
+
+float predict(const Perceptron *p, const float *inputs) {
+    float sum = 0;
+    for (int j = 0; j < p->num_weights; j++)
+        sum += p->w[j] * inputs[j];
+    sum += p->b;
+    return activation_fn(sum);
+}
+
+// Scores n input rows spaced `stride` floats apart (so dataset rows can be
+// passed as-is; only the first num_weights floats of a row are read). With
+// SSE2, four rows go at a time: 4x4 blocks of inputs are transposed so each
+// weight multiplies a whole column, and the sigmoid runs on all four sums.
+void predict_batch(const Perceptron *p, const float *inputs, int stride, int n,
+                   float *outputs) {
+    int nw = p->num_weights;
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= n; i += 4) {
+        const float *r0 = inputs + (size_t)i * stride;
+        const float *r1 = r0 + stride, *r2 = r1 + stride, *r3 = r2 + stride;
+        __m128 sum = _mm_set1_ps(p->b);
+        int j = 0;
+        for (; j + 4 <= nw; j += 4) {
+            __m128 c0 = _mm_loadu_ps(r0 + j), c1 = _mm_loadu_ps(r1 + j);
+            __m128 c2 = _mm_loadu_ps(r2 + j), c3 = _mm_loadu_ps(r3 + j);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            sum = _mm_add_ps(sum, _mm_mul_ps(c0, _mm_set1_ps(p->w[j])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(p->w[j + 1])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(p->w[j + 2])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(p->w[j + 3])));
+        }
+        for (; j < nw; j++) {
+            __m128 c = _mm_set_ps(r3[j], r2[j], r1[j], r0[j]);
+            sum = _mm_add_ps(sum, _mm_mul_ps(c, _mm_set1_ps(p->w[j])));
+        }
+        __m128 e = exp_ps(_mm_sub_ps(_mm_setzero_ps(), sum));
+        _mm_storeu_ps(outputs + i, _mm_div_ps(one, _mm_add_ps(one, e)));
+    }
+#endif
+    for (; i < n; i++)
+        outputs[i] = predict(p, inputs + (size_t)i * stride);
+}
+
+void reset_optimizer_state(Perceptron *p) {
+    memset(p->m, 0, sizeof(float) * p->num_weights);
+    memset(p->v, 0, sizeof(float) * p->num_weights);
+    p->mb = p->vb = 0;
+    p->t = 0;
+    p->epoch = 0;
+    p->beta1_t = p->beta2_t = 1.0f;
+}
+
+void init_perceptron(Perceptron *p, int input_size) {
+    p->w = malloc(sizeof(float) * input_size * 3);
+    p->m = p->w + input_size;
+    p->v = p->w + input_size * 2;
+    p->num_weights = input_size;
+    p->b = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    for (int i = 0; i < input_size; i++)
+        p->w[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    reset_optimizer_state(p);
+    p->version++;
+}
+
+void reset_perceptron(Perceptron *p) {
+    p->b = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    for (int i = 0; i < p->num_weights; i++)
+        p->w[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    reset_optimizer_state(p);
+    p->version++;
+}
+
+// ── Datasets ────────────────────────────────────────────────
+
+// Rows are stored back to back in one aligned buffer: dim inputs, then the
+// expected output, padded to `stride` floats so every row starts aligned.
+
+#define DATASET_ALIGN 64
+
+typedef struct {
+    char name[32];
+    float *data;
+    int count;
+    int dim;        // number of inputs
+    int stride;     // floats per row, >= dim + 1
+    float lo[2];    // bounds of the first two inputs, for plotting
+    float hi[2];
+} DatasetInfo;
+
+typedef struct {
+    size_t capacity;
+    size_t count;
+    DatasetInfo *items;
+} Datasets;
+
+float *dataset_row(const DatasetInfo *ds, int i) {
+    return ds->data + (size_t)i * ds->stride;
+}
+
+float dataset_label(const DatasetInfo *ds, int i) {
+    return dataset_row(ds, i)[ds->dim];
+}
+
+bool alloc_dataset(DatasetInfo *ds, const char *name, int count, int dim) {
+    snprintf(ds->name, sizeof(ds->name), "%s", name);
+    ds->count = count;
+    ds->dim = dim;
+    ds->stride = (dim + 1 + 3) & ~3;
+    size_t bytes = (size_t)count * ds->stride * sizeof(float);
+    bytes = (bytes + DATASET_ALIGN - 1) & ~(size_t)(DATASET_ALIGN - 1);
+    ds->data = aligned_alloc(DATASET_ALIGN, bytes ? bytes : DATASET_ALIGN);
+    if (!ds->data) return false;
+    memset(ds->data, 0, bytes);
+    return true;
+}
+
+void compute_dataset_bounds(DatasetInfo *ds) {
+    for (int k = 0; k < 2; k++) {
+        ds->lo[k] = 0.0f;
+        ds->hi[k] = 1.0f;
+        if (k >= ds->dim || ds->count == 0) continue;
+        float lo = dataset_row(ds, 0)[k], hi = lo;
+        for (int i = 1; i < ds->count; i++) {
+            float v = dataset_row(ds, i)[k];
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        if (hi - lo < 1e-6f) { lo -= 0.5f; hi += 0.5f; }
+        ds->lo[k] = lo;
+        ds->hi[k] = hi;
+    }
+}
+
+void add_table_dataset(Datasets *out, const char *name, const float *table,
+                       int count, int dim) {
+    DatasetInfo ds = {0};
+    if (!alloc_dataset(&ds, name, count, dim)) return;
+    for (int i = 0; i < count; i++)
+        memcpy(dataset_row(&ds, i), table + i * (dim + 1), sizeof(float) * (dim + 1));
+    compute_dataset_bounds(&ds);
+    da_append(out, ds);
+}
+
+// Numeric CSV, one sample per line, last column is the expected output.
+// A non-numeric first line is treated as a header. A non-numeric label
+// column becomes 1 for the first row's label and 0 otherwise (one-vs-rest).
+bool load_dataset_csv(const char *path, DatasetInfo *out) {
+    String_Builder sb = {0};
+    if (!read_entire_file(path, &sb)) return false;
+    da_append(&sb, '\0');
+
+    // First pass: skip the header, count rows and columns
+    char *first = NULL;
+    int count = 0, cols = 0;
+    for (char *line = sb.items; *line; ) {
+        size_t len = strcspn(line, "\n");
+        if (len > 0 && line[0] != '\r') {
+            char *end;
+            strtof(line, &end);
+            if (first || end != line) {
+                if (!first) {
+                    first = line;
+                    cols = 1;
+                    for (size_t k = 0; k < len; k++)
+                        if (line[k] == ',') cols++;
+                }
+                count++;
+            }
+        }
+        line += len + (line[len] == '\n');
+    }
+    if (count == 0 || cols < 2) {
+        fprintf(stderr, "%s: no samples\n", path);
+        da_free(sb);
+        return false;
+    }
+
+    const char *base = strrchr(path, '/');
+    if (!alloc_dataset(out, base ? base + 1 : path, count, cols - 1)) {
+        da_free(sb);
+        return false;
+    }
+
+    // Second pass: parse into the aligned rows
+    char pos_label[64] = {0};
+    int row = 0;
+    for (char *line = first; *line && row < count; ) {
+        size_t len = strcspn(line, "\n");
+        if (len > 0 && line[0] != '\r') {
+            float *r = dataset_row(out, row);
+            char *cur = line;
+            for (int c = 0; c < cols && cur < line + len; c++) {
+                while (*cur == ' ' || *cur == '"') cur++;
+                char *end;
+                float v = strtof(cur, &end);
+                if (end == cur && c == cols - 1) {
+                    char lbl[64] = {0};
+                    size_t n = strcspn(cur, "\",\r\n");
+                    if (n >= sizeof(lbl)) n = sizeof(lbl) - 1;
+                    memcpy(lbl, cur, n);
+                    if (row == 0) memcpy(pos_label, lbl, sizeof(lbl));
+                    v = strcmp(lbl, pos_label) == 0 ? 1.0f : 0.0f;
+                }
+                r[c] = v;
+                cur += strcspn(cur, ",\n") + 1;
+            }
+            row++;
+        }
+        line += len + (line[len] == '\n');
+    }
+    compute_dataset_bounds(out);
+    da_free(sb);
+    return true;
+}
+
+float AND_Dataset[4][3] = {
+    {0, 0, 0}, {0, 1, 0}, {1, 0, 0}, {1, 1, 1}
+};
+float OR_Dataset[4][3] = {
+    {0, 0, 0}, {0, 1, 1}, {1, 0, 1}, {1, 1, 1}
+};
+float NAND_Dataset[4][3] = {
+    {0, 0, 1}, {0, 1, 1}, {1, 0, 1}, {1, 1, 0}
+};
+float XOR_Dataset[4][3] = {
+    {0, 0, 0}, {0, 1, 1}, {1, 0, 1}, {1, 1, 0}
+};
+
+void add_gate_datasets(Datasets *out) {
+    add_table_dataset(out, "AND",  &AND_Dataset[0][0],  4, 2);
+    add_table_dataset(out, "OR",   &OR_Dataset[0][0],   4, 2);
+    add_table_dataset(out, "NAND", &NAND_Dataset[0][0], 4, 2);
+    add_table_dataset(out, "XOR",  &XOR_Dataset[0][0],  4, 2);
+}
+
+// ── Optimizers ──────────────────────────────────────────────
+
+typedef enum {
+    OPT_SGD = 0,
+    OPT_MOMENTUM,
+    OPT_NESTEROV,
+    OPT_ADAM,
+    OPT_COUNT
+} OptimizerKind;
+
+typedef enum {
+    LR_CONSTANT = 0,
+    LR_STEP,      // lr * gamma^(epoch / step_size)
+    LR_COSINE,    // cosine from lr to lr_min, restarting every period epochs
+    LR_SCHEDULE_COUNT
+} LrSchedule;
+
+typedef struct {
+    OptimizerKind kind;
+    float lr;
+    float momentum;       // Momentum / Nesterov
+    float beta1, beta2;   // Adam
+    float eps;
+    LrSchedule schedule;
+    int step_size;
+    float gamma;
+    int period;
+    float lr_min;
+} Optimizer;
+
+const char *OPTIMIZER_NAMES[OPT_COUNT] = {"SGD", "Momentum", "Nesterov", "Adam"};
+const char *LR_SCHEDULE_NAMES[LR_SCHEDULE_COUNT] = {"constant", "step", "cosine"};
+
+Optimizer optimizer_default(OptimizerKind kind) {
+    Optimizer o = {
+        .kind = kind,
+        .lr = 0.1f,
+        .momentum = 0.9f,
+        .beta1 = 0.9f,
+        .beta2 = 0.999f,
+        .eps = 1e-8f,
+        .schedule = LR_CONSTANT,
+        .step_size = 1000,
+        .gamma = 0.5f,
+        .period = 2000,
+        .lr_min = 0.0f,
+    };
+    if (kind == OPT_MOMENTUM || kind == OPT_NESTEROV) o.lr = 0.05f;
+    if (kind == OPT_ADAM) o.lr = 0.05f;
+    return o;
+}
+
+float optimizer_lr(const Optimizer *o, long long epoch) {
+    switch (o->schedule) {
+        case LR_STEP:
+            return o->lr * powf(o->gamma, (float)(epoch / (o->step_size > 0 ? o->step_size : 1)));
+        case LR_COSINE: {
+            int period = o->period > 0 ? o->period : 1;
+            float phase = (float)(epoch % period) / (float)period;
+            return o->lr_min + 0.5f * (o->lr - o->lr_min) * (1.0f + cosf(phase * 3.14159265f));
+        }
+        default:
+            return o->lr;
+    }
+}
+
+// ── Training ────────────────────────────────────────────────
+
+// One online pass over the dataset. The gradient of each sample is
+// error * x (error * 1 for the bias) and goes through the optimizer.
+void train_step(Perceptron *p, const Optimizer *opt, const DatasetInfo *ds, float *mse) {
+    int n = p->num_weights;
+    float lr = optimizer_lr(opt, p->epoch);
+    float mu = opt->momentum;
+    float b1 = opt->beta1, b2 = opt->beta2;
+    float total_error = 0;
+
+    for (int i = 0; i < ds->count; i++) {
+        const float *data = dataset_row(ds, i);
+        float expected = data[ds->dim];
+        float sum = p->b;
+        for (int j = 0; j < n; j++)
+            sum += p->w[j] * data[j];
+        float output = activation_fn(sum);
+        float error = output - expected;
+        total_error += error * error;
+        p->t++;
+
+        switch (opt->kind) {
+            case OPT_SGD:
+                for (int j = 0; j < n; j++)
+                    p->w[j] -= lr * error * data[j];
+                p->b -= lr * error;
+                break;
+            case OPT_MOMENTUM:
+                for (int j = 0; j < n; j++) {
+                    p->m[j] = mu * p->m[j] + error * data[j];
+                    p->w[j] -= lr * p->m[j];
+                }
+                p->mb = mu * p->mb + error;
+                p->b -= lr * p->mb;
+                break;
+            case OPT_NESTEROV:
+                for (int j = 0; j < n; j++) {
+                    float g = error * data[j];
+                    p->m[j] = mu * p->m[j] + g;
+                    p->w[j] -= lr * (g + mu * p->m[j]);
+                }
+                p->mb = mu * p->mb + error;
+                p->b -= lr * (error + mu * p->mb);
+                break;
+            case OPT_ADAM: {
+                p->beta1_t *= b1;
+                p->beta2_t *= b2;
+                float step = lr * sqrtf(1.0f - p->beta2_t) / (1.0f - p->beta1_t);
+                for (int j = 0; j < n; j++) {
+                    float g = error * data[j];
+                    p->m[j] = b1 * p->m[j] + (1.0f - b1) * g;
+                    p->v[j] = b2 * p->v[j] + (1.0f - b2) * g * g;
+                    p->w[j] -= step * p->m[j] / (sqrtf(p->v[j]) + opt->eps);
+                }
+                p->mb = b1 * p->mb + (1.0f - b1) * error;
+                p->vb = b2 * p->vb + (1.0f - b2) * error * error;
+                p->b -= step * p->mb / (sqrtf(p->vb) + opt->eps);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    *mse = ds->count ? total_error / (float)ds->count : 0.0f;
+    p->epoch++;
+    p->version++;
+}
+
+// Mean squared error at the current weights, without training.
+float evaluate_mse(const Perceptron *p, const DatasetInfo *ds) {
+    float total = 0;
+    for (int i = 0; i < ds->count; i++) {
+        const float *data = dataset_row(ds, i);
+        float error = predict(p, data) - data[ds->dim];
+        total += error * error;
+    }
+    return ds->count ? total / ds->count : 0.0f;
+}
+
+// Norm of the full-batch gradient at the current weights. Costs a forward
+// pass, so convergence checks call it once per window, not per epoch.
+float gradient_norm(const Perceptron *p, const DatasetInfo *ds) {
+    int n = p->num_weights;
+    float gb = 0, sq = 0;
+    float *g = calloc(n > 0 ? n : 1, sizeof(float));
+    for (int i = 0; i < ds->count; i++) {
+        const float *data = dataset_row(ds, i);
+        float error = predict(p, data) - data[ds->dim];
+        for (int j = 0; j < n; j++)
+            g[j] += error * data[j];
+        gb += error;
+    }
+    for (int j = 0; j < n; j++) sq += g[j] * g[j];
+    sq += gb * gb;
+    free(g);
+    return ds->count ? sqrtf(sq) / ds->count : 0.0f;
+}
+
+#endif
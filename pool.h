@@ -0,0 +1,142 @@
+#ifndef POOL_H
+#define POOL_H
+
+// Fork-join thread pool. pool_run() hands out task indices 0..num_tasks-1
+// to the workers, the calling thread included, and returns once all of
+// them finished. Worker ids (0 = caller) let tasks use per-worker scratch.
+// On the web build there are no threads and tasks run inline.
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+typedef void (*PoolTask)(void *ctx, int task, int worker);
+
+typedef struct {
+    int num_threads;        // workers including the caller
+#if !defined(PLATFORM_WEB)
+    pthread_t *threads;
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+#endif
+    PoolTask task;
+    void *ctx;
+    int num_tasks;
+    int next_task;
+    int running;            // tasks claimed but not finished
+    unsigned generation;    // bumped by every pool_run()
+    bool quit;
+} ThreadPool;
+
+int pool_default_threads(void) {
+#if defined(PLATFORM_WEB)
+    return 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+#if !defined(PLATFORM_WEB)
+
+typedef struct {
+    ThreadPool *pool;
+    int worker;
+} PoolWorkerArg;
+
+// Claims and runs tasks until none are left. Called with the lock held.
+void pool_drain_locked(ThreadPool *p, int worker) {
+    while (p->next_task < p->num_tasks) {
+        int t = p->next_task++;
+        p->running++;
+        pthread_mutex_unlock(&p->lock);
+        p->task(p->ctx, t, worker);
+        pthread_mutex_lock(&p->lock);
+        p->running--;
+    }
+    if (p->running == 0) pthread_cond_broadcast(&p->done_cv);
+}
+
+void *pool_worker_main(void *arg) {
+    PoolWorkerArg a = *(PoolWorkerArg *)arg;
+    free(arg);
+    ThreadPool *p = a.pool;
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        while (!p->quit && p->generation == seen)
+            pthread_cond_wait(&p->work_cv, &p->lock);
+        if (p->quit) break;
+        seen = p->generation;
+        pool_drain_locked(p, a.worker);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+#endif
+
+void pool_init(ThreadPool *p, int num_threads) {
+    *p = (ThreadPool){0};
+    p->num_threads = num_threads > 0 ? num_threads : 1;
+#if defined(PLATFORM_WEB)
+    p->num_threads = 1;
+#else
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->work_cv, NULL);
+    pthread_cond_init(&p->done_cv, NULL);
+    p->threads = calloc(p->num_threads, sizeof(pthread_t));
+    for (int i = 1; i < p->num_threads; i++) {
+        PoolWorkerArg *arg = malloc(sizeof(*arg));
+        *arg = (PoolWorkerArg){p, i};
+        pthread_create(&p->threads[i], NULL, pool_worker_main, arg);
+    }
+#endif
+}
+
+void pool_run(ThreadPool *p, PoolTask task, void *ctx, int num_tasks) {
+#if defined(PLATFORM_WEB)
+    for (int t = 0; t < num_tasks; t++) task(ctx, t, 0);
+#else
+    if (p->num_threads == 1) {
+        for (int t = 0; t < num_tasks; t++) task(ctx, t, 0);
+        return;
+    }
+    pthread_mutex_lock(&p->lock);
+    p->task = task;
+    p->ctx = ctx;
+    p->num_tasks = num_tasks;
+    p->next_task = 0;
+    p->running = 0;
+    p->generation++;
+    pthread_cond_broadcast(&p->work_cv);
+    pool_drain_locked(p, 0);
+    while (p->next_task < p->num_tasks || p->running > 0)
+        pthread_cond_wait(&p->done_cv, &p->lock);
+    pthread_mutex_unlock(&p->lock);
+#endif
+}
+
+void pool_free(ThreadPool *p) {
+#if !defined(PLATFORM_WEB)
+    pthread_mutex_lock(&p->lock);
+    p->quit = true;
+    pthread_cond_broadcast(&p->work_cv);
+    pthread_mutex_unlock(&p->lock);
+    for (int i = 1; i < p->num_threads; i++)
+        pthread_join(p->threads[i], NULL);
+    free(p->threads);
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->work_cv);
+    pthread_cond_destroy(&p->done_cv);
+#endif
+    *p = (ThreadPool){0};
+}
+
+#endif
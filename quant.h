@@ -0,0 +1,162 @@
+#ifndef QUANT_H
+#define QUANT_H
+
+// Fixed-point inference for a trained Perceptron. Include perceptron.h first.
+//
+// Inputs are quantized per feature to int8 (x ~ q * in_scale[j]); the input
+// scales are folded into the weights, which share one int8 scale, so the
+// pre-activation is an int32 dot product plus an int32 bias. A Q16
+// multiplier maps the accumulator straight into a sigmoid table of Q15
+// outputs, so scoring never touches float.
+//
+// Batches are stored column-major (one int8 column per input) so the kernel
+// runs across rows: 16 rows per SSE2 step, or a scalar loop elsewhere.
+
+#include <stdint.h>
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#define Q8_LUT_SIZE  4096
+#define Q8_LUT_RANGE 16.0f
+#define Q8_ONE       32767
+
+typedef struct {
+    int num_weights;
+    int8_t *w;          // w_j * in_scale_j / w_scale
+    float *in_scale;    // per input: x_q = round(x / in_scale)
+    float w_scale;      // pre-activation per accumulator unit
+    int32_t b;          // bias in accumulator units
+    int32_t lut_mult;   // accumulator -> LUT index, Q16
+    int16_t lut[Q8_LUT_SIZE];
+} QPerceptron;
+
+typedef struct {
+    int n;
+    int dim;
+    int8_t *cols;       // dim columns of n values each
+} QBatch;
+
+int8_t q8_clamp(float v) {
+    long r = lroundf(v);
+    if (r > 127) r = 127;
+    if (r < -127) r = -127;
+    return (int8_t)r;
+}
+
+// Calibrates input ranges on `calib` and quantizes the trained weights.
+void quantize_perceptron(const Perceptron *p, const DatasetInfo *calib, QPerceptron *q) {
+    int n = p->num_weights;
+    q->num_weights = n;
+    q->w = malloc(n > 0 ? n : 1);
+    q->in_scale = malloc(sizeof(float) * (n > 0 ? n : 1));
+
+    float max_w = 0;
+    for (int j = 0; j < n; j++) {
+        float max_x = 0;
+        for (int i = 0; i < calib->count; i++) {
+            float v = fabsf(dataset_row(calib, i)[j]);
+            if (v > max_x) max_x = v;
+        }
+        q->in_scale[j] = max_x > 0 ? max_x / 127.0f : 1.0f;
+        float folded = fabsf(p->w[j] * q->in_scale[j]);
+        if (folded > max_w) max_w = folded;
+    }
+
+    q->w_scale = max_w > 0 ? max_w / 127.0f : 1.0f;
+    for (int j = 0; j < n; j++)
+        q->w[j] = q8_clamp(p->w[j] * q->in_scale[j] / q->w_scale);
+    q->b = (int32_t)lroundf(p->b / q->w_scale);
+
+    float lut_per_unit = (Q8_LUT_SIZE - 1) / (2.0f * Q8_LUT_RANGE);
+    q->lut_mult = (int32_t)lroundf(q->w_scale * lut_per_unit * 65536.0f);
+    for (int k = 0; k < Q8_LUT_SIZE; k++) {
+        float z = (float)k / lut_per_unit - Q8_LUT_RANGE;
+        q->lut[k] = (int16_t)lroundf(activation_fn(z) * Q8_ONE);
+    }
+}
+
+void free_qperceptron(QPerceptron *q) {
+    free(q->w);
+    free(q->in_scale);
+    q->w = NULL;
+    q->in_scale = NULL;
+}
+
+// Quantizes count rows of ds, starting at `first`, into a column batch.
+void quantize_batch(const QPerceptron *q, const DatasetInfo *ds, int first, int count,
+                    QBatch *out) {
+    out->n = count;
+    out->dim = q->num_weights;
+    out->cols = malloc((size_t)count * out->dim + 16);
+    float *inv = malloc(sizeof(float) * (out->dim > 0 ? out->dim : 1));
+    for (int j = 0; j < out->dim; j++) inv[j] = 1.0f / q->in_scale[j];
+
+    // Rows are read in order and scattered to the columns
+    for (int i = 0; i < count; i++) {
+        const float *row = dataset_row(ds, first + i);
+        for (int j = 0; j < out->dim; j++) {
+            float v = row[j] * inv[j];
+            v = v > 127.0f ? 127.0f : v < -127.0f ? -127.0f : v;
+            out->cols[(size_t)j * count + i] = (int8_t)(v + (v >= 0 ? 0.5f : -0.5f));
+        }
+    }
+    free(inv);
+}
+
+void free_qbatch(QBatch *b) {
+    free(b->cols);
+    b->cols = NULL;
+}
+
+int16_t q8_activate(const QPerceptron *q, int32_t acc) {
+    int64_t k = (((int64_t)acc * q->lut_mult) >> 16) + Q8_LUT_SIZE / 2;
+    if (k < 0) k = 0;
+    if (k > Q8_LUT_SIZE - 1) k = Q8_LUT_SIZE - 1;
+    return q->lut[k];
+}
+
+#define Q8_BLOCK 256
+
+// Scores every row of `batch` into Q15 outputs (Q8_ONE == 1.0).
+void predict_q8_batch(const QPerceptron *q, const QBatch *batch, int16_t *out) {
+    int32_t acc[Q8_BLOCK];
+    int n = batch->n;
+
+    for (int start = 0; start < n; start += Q8_BLOCK) {
+        int len = n - start < Q8_BLOCK ? n - start : Q8_BLOCK;
+        for (int i = 0; i < len; i++) acc[i] = q->b;
+
+        for (int j = 0; j < batch->dim; j++) {
+            const int8_t *col = batch->cols + (size_t)j * n + start;
+            int32_t wj = q->w[j];
+            int i = 0;
+#if defined(__SSE2__)
+            __m128i wv = _mm_set1_epi16((int16_t)wj);
+            for (; i + 16 <= len; i += 16) {
+                __m128i x = _mm_loadu_si128((const __m128i *)(col + i));
+                __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+                __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+                __m128i plo = _mm_mullo_epi16(lo, wv);  // |p| <= 127 * 127 fits int16
+                __m128i phi = _mm_mullo_epi16(hi, wv);
+                __m128i *a = (__m128i *)(acc + i);
+                _mm_storeu_si128(a + 0, _mm_add_epi32(_mm_loadu_si128(a + 0),
+                                 _mm_srai_epi32(_mm_unpacklo_epi16(plo, plo), 16)));
+                _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1),
+                                 _mm_srai_epi32(_mm_unpackhi_epi16(plo, plo), 16)));
+                _mm_storeu_si128(a + 2, _mm_add_epi32(_mm_loadu_si128(a + 2),
+                                 _mm_srai_epi32(_mm_unpacklo_epi16(phi, phi), 16)));
+                _mm_storeu_si128(a + 3, _mm_add_epi32(_mm_loadu_si128(a + 3),
+                                 _mm_srai_epi32(_mm_unpackhi_epi16(phi, phi), 16)));
+            }
+#endif
+            for (; i < len; i++)
+                acc[i] += wj * col[i];
+        }
+
+        for (int i = 0; i < len; i++)
+            out[start + i] = q8_activate(q, acc[i]);
+    }
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef RFF_H
+#define RFF_H
+
+// Random Fourier features (Rahimi & Recht 2007) for the RBF kernel
+// K(x, y) = exp(-gamma |x - y|^2). Include vmath.h first.
+//
+//     z(x)_j = sqrt(2 / D) cos(w_j . x + b_j),   w_j ~ N(0, 2 gamma I),
+//                                                b_j ~ U[0, 2 pi)
+//
+// so z(x) . z(y) approximates K(x, y) with error O(1 / sqrt(D)). A linear
+// model on z then stands in for the kernel machine: training is linear in
+// n and prediction costs O(D dim) whatever the number of support vectors.
+//
+// Frequencies are stored feature-major (one row of `cap` values per input
+// dimension), so rff_transform() produces four outputs at a time with one
+// broadcast per input value and cos_ps().
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct {
+    int dim;                // input features
+    int out;                // D, random features
+    int cap;                // out rounded up to 4
+    float gamma;
+    float scale;            // sqrt(2 / D)
+    float *freq;            // dim rows of cap frequencies
+    float *phase;           // cap offsets
+} RffMap;
+
+// Box-Muller on a private xorshift so the caller's rand() stream is left
+// alone.
+float rff_randn(uint32_t *state) {
+    float u[2];
+    for (int k = 0; k < 2; k++) {
+        *state ^= *state << 13;
+        *state ^= *state >> 17;
+        *state ^= *state << 5;
+        u[k] = ((*state >> 8) + 0.5f) / 16777216.0f;
+    }
+    return sqrtf(-2.0f * logf(u[0])) * cosf(6.2831853f * u[1]);
+}
+
+void rff_init(RffMap *m, int dim, int out, float gamma, uint32_t seed) {
+    *m = (RffMap){0};
+    m->dim = dim;
+    m->out = out;
+    m->cap = (out + 3) & ~3;
+    m->gamma = gamma;
+    m->scale = sqrtf(2.0f / out);
+    m->freq = calloc((size_t)dim * m->cap, sizeof(float));
+    m->phase = calloc(m->cap, sizeof(float));
+
+    uint32_t state = seed ? seed : 1;
+    float sigma = sqrtf(2.0f * gamma);
+    for (int j = 0; j < out; j++) {
+        for (int d = 0; d < dim; d++) m->freq[(size_t)d * m->cap + j] = sigma * rff_randn(&state);
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        m->phase[j] = ((state >> 8) + 0.5f) / 16777216.0f * 6.2831853f;
+    }
+}
+
+void rff_free(RffMap *m) {
+    free(m->freq);
+    free(m->phase);
+    *m = (RffMap){0};
+}
+
+// Maps n row-major inputs to n rows of m->out features in Z.
+void rff_transform(const RffMap *m, const float *X, int n, float *Z) {
+    for (int i = 0; i < n; i++) {
+        const float *x = X + (size_t)i * m->dim;
+        float *z = Z + (size_t)i * m->out;
+        int j = 0;
+#if defined(__SSE2__)
+        __m128 scale = _mm_set1_ps(m->scale);
+        for (; j < m->cap; j += 4) {
+            __m128 acc = _mm_loadu_ps(m->phase + j);
+            for (int d = 0; d < m->dim; d++)
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(x[d]),
+                                                 _mm_loadu_ps(m->freq + (size_t)d * m->cap + j)));
+            acc = _mm_mul_ps(scale, cos_ps(acc));
+            if (j + 4 <= m->out) {
+                _mm_storeu_ps(z + j, acc);
+            } else {
+                float tail[4];
+                _mm_storeu_ps(tail, acc);
+                for (int k = 0; j + k < m->out; k++) z[j + k] = tail[k];
+            }
+        }
+#endif
+        for (; j < m->out; j++) {
+            float a = m->phase[j];
+            for (int d = 0; d < m->dim; d++) a += x[d] * m->freq[(size_t)d * m->cap + j];
+            z[j] = m->scale * cosf(a);
+        }
+    }
+}
+
+#endif
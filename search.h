@@ -0,0 +1,169 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+// Hyperparameter search for svm.c's per-sample training rule
+//
+//     y (w.x + b) >= 1:  w <- w - lr lambda w
+//     otherwise:         w <- w - lr (lambda w - y x),   b <- b + lr y
+//
+// over learning rate, regularization strength and epoch count. Configs come
+// from a full grid, from log-uniform random draws, or both. Every config
+// trains from w = 0 as its own pool task on one shared, read-only dataset,
+// writing only its own SearchConfig. Include nob.h and pool.h first.
+//
+// Each config is fit on the training rows and scored on the held-out ones
+// (every `holdout`-th row), then the list is ranked by validation accuracy,
+// ties going to the lower mean validation hinge loss and then to the wider
+// geometric margin, min y f / |w|, on the held-out rows: on separable data
+// many configs tie on the first two.
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SEARCH_MAX_DIM 8
+
+typedef struct {
+    float lr;
+    float lambda;
+    int epochs;
+    bool random;            // drawn rather than from the grid
+
+    float w[SEARCH_MAX_DIM];
+    float b;
+    float train_acc;
+    float val_acc;
+    float val_hinge;        // mean max(0, 1 - y f) on the held-out rows
+    float val_margin;       // min y f / |w| on the held-out rows
+    double ms;
+} SearchConfig;
+
+typedef struct {
+    SearchConfig *items;
+    size_t count;
+    size_t capacity;
+} SearchConfigs;
+
+// Appends every combination of the given values.
+void search_grid(SearchConfigs *cs, const float *lrs, int n_lr, const float *lambdas,
+                 int n_lambda, const int *epochs, int n_epochs) {
+    for (int a = 0; a < n_lr; a++)
+        for (int l = 0; l < n_lambda; l++)
+            for (int e = 0; e < n_epochs; e++)
+                da_append(cs, ((SearchConfig){.lr = lrs[a], .lambda = lambdas[l],
+                                              .epochs = epochs[e]}));
+}
+
+float search_uniform(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return (*state >> 8) / 16777216.0f;
+}
+
+// Appends `count` configs with lr, lambda and epochs each log-uniform in
+// [lo, hi].
+void search_random(SearchConfigs *cs, int count, float lr_lo, float lr_hi, float lambda_lo,
+                   float lambda_hi, int epochs_lo, int epochs_hi, uint32_t seed) {
+    uint32_t state = seed ? seed : 1;
+    for (int k = 0; k < count; k++) {
+        SearchConfig c = {.random = true};
+        c.lr = lr_lo * powf(lr_hi / lr_lo, search_uniform(&state));
+        c.lambda = lambda_lo * powf(lambda_hi / lambda_lo, search_uniform(&state));
+        c.epochs = (int)(epochs_lo * powf((float)epochs_hi / epochs_lo, search_uniform(&state)));
+        da_append(cs, c);
+    }
+}
+
+typedef struct {
+    SearchConfig *configs;
+    const float *X;         // shared, read-only
+    const int *y;
+    int n;
+    int dim;
+    int holdout;
+} SearchCtx;
+
+float search_decision(const SearchConfig *c, const float *x, int dim) {
+    float f = c->b;
+    for (int d = 0; d < dim; d++) f += c->w[d] * x[d];
+    return f;
+}
+
+void search_task(void *ctx, int task, int worker) {
+    (void)worker;
+    SearchCtx *sc = ctx;
+    SearchConfig *c = &sc->configs[task];
+    int dim = sc->dim;
+    uint64_t t0 = nanos_since_unspecified_epoch();
+
+    memset(c->w, 0, sizeof(c->w));
+    c->b = 0;
+    for (int e = 0; e < c->epochs; e++) {
+        for (int i = 0; i < sc->n; i++) {
+            if (i % sc->holdout == 0) continue;
+            const float *x = sc->X + (size_t)i * dim;
+            float yi = (float)sc->y[i];
+            float margin = yi * search_decision(c, x, dim);
+            for (int d = 0; d < dim; d++) {
+                float grad = c->lambda * c->w[d];
+                if (margin < 1) grad -= yi * x[d];
+                c->w[d] -= c->lr * grad;
+            }
+            if (margin < 1) c->b += c->lr * yi;
+        }
+    }
+
+    float norm = 0;
+    for (int d = 0; d < dim; d++) norm += c->w[d] * c->w[d];
+    norm = sqrtf(norm);
+
+    int train_ok = 0, train_n = 0, val_ok = 0, val_n = 0;
+    float hinge = 0, margin = INFINITY;
+    for (int i = 0; i < sc->n; i++) {
+        float f = search_decision(c, sc->X + (size_t)i * dim, dim);
+        bool ok = (f >= 0) == (sc->y[i] > 0);
+        if (i % sc->holdout == 0) {
+            val_ok += ok;
+            val_n++;
+            float h = 1.0f - sc->y[i] * f;
+            if (h > 0) hinge += h;
+            if (sc->y[i] * f < margin) margin = sc->y[i] * f;
+        } else {
+            train_ok += ok;
+            train_n++;
+        }
+    }
+    c->train_acc = train_n ? (float)train_ok / train_n : 0;
+    c->val_acc = val_n ? (float)val_ok / val_n : 0;
+    c->val_hinge = val_n ? hinge / val_n : 0;
+    c->val_margin = val_n && norm > 0 ? margin / norm : -INFINITY;
+    c->ms = (nanos_since_unspecified_epoch() - t0) / 1e6;
+}
+
+int search_compare(const void *a, const void *b) {
+    const SearchConfig *x = a, *y = b;
+    if (x->val_acc != y->val_acc) return x->val_acc > y->val_acc ? -1 : 1;
+    if (x->val_hinge != y->val_hinge) return x->val_hinge < y->val_hinge ? -1 : 1;
+    if (x->val_margin != y->val_margin) return x->val_margin > y->val_margin ? -1 : 1;
+    return 0;
+}
+
+// Trains and scores every config on n row-major samples with labels +1 / -1
+// (dim <= SEARCH_MAX_DIM), then sorts them best first. `pool` may be NULL.
+void search_run(SearchConfigs *cs, const float *X, const int *y, int n, int dim, int holdout,
+                ThreadPool *pool) {
+    assert(dim > 0 && dim <= SEARCH_MAX_DIM);
+    SearchCtx ctx = {cs->items, X, y, n, dim, holdout > 1 ? holdout : 2};
+    if (pool) {
+        pool_run(pool, search_task, &ctx, (int)cs->count);
+    } else {
+        for (size_t k = 0; k < cs->count; k++) search_task(&ctx, (int)k, 0);
+    }
+    qsort(cs->items, cs->count, sizeof(SearchConfig), search_compare);
+}
+
+#endif
@@ -0,0 +1,345 @@
+#ifndef SMO_H
+#define SMO_H
+
+// Sequential Minimal Optimization for the soft-margin SVM dual
+//
+//     min  1/2 a'Qa - e'a   s.t.  0 <= a_i <= C,  y'a = 0,
+//     Q_ij = y_i y_j K(x_i, x_j)
+//
+// following LIBSVM: each iteration picks the maximal-violating i and the j
+// with the best second-order gain, solves the two-variable subproblem in
+// closed form, and updates the gradient G = Qa - e (the error cache) with
+// two kernel rows. It stops once the KKT violation m(a) - M(a) drops below
+// eps, which bounds the distance to the exact optimum. Include kernel.h
+// first.
+//
+// Kernel rows come from smo_get_row(). A row is computed from a
+// column-major copy of the inputs four points at a time and kept in an LRU
+// cache bounded by `cache_bytes`; the working set keeps returning to the
+// same few hundred free vectors, so once the cache covers them most
+// iterations compute no kernel values at all.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define SMO_TAU 1e-12
+#define SMO_DEFAULT_CACHE_BYTES (64u << 20)
+
+typedef struct {
+    int n;
+    int dim;
+    int cap;                // n rounded up to 4
+    float *cols;            // dim columns of cap values
+    const int *y;           // labels, +1 / -1
+    Kernel kernel;
+    double C;
+    double eps;             // KKT violation tolerance
+    long long max_iter;
+
+    double *alpha;
+    double *G;              // gradient of the dual, one entry per point
+    float *diag;            // K(x_i, x_i)
+    const float *row_i;     // row of the last selected i, owned by the cache
+    float *xq;              // scratch query point, dim values
+    float *scratch;         // cap values, for smo_decision()
+
+    // Kernel row cache: rows[i] is K(x_i, .) or NULL, linked most recent
+    // first through lru_prev / lru_next with n as the list head.
+    size_t cache_bytes;
+    int cache_rows;         // rows that fit in cache_bytes, at least 2
+    int cached;
+    float **rows;
+    int *lru_prev, *lru_next;
+    long long cache_hits;
+
+    long long iter;
+    long long rows_computed;
+    double gap;             // last m(a) - M(a)
+    double b;               // decision is sum a_i y_i K(x_i, x) + b
+    bool converged;
+} SmoSolver;
+
+// ── Kernel row cache ────────────────────────────────────────
+
+void smo_cache_unlink(SmoSolver *s, int i) {
+    s->lru_next[s->lru_prev[i]] = s->lru_next[i];
+    s->lru_prev[s->lru_next[i]] = s->lru_prev[i];
+}
+
+void smo_cache_push_front(SmoSolver *s, int i) {
+    int head = s->n;
+    s->lru_prev[i] = head;
+    s->lru_next[i] = s->lru_next[head];
+    s->lru_prev[s->lru_next[head]] = i;
+    s->lru_next[head] = i;
+}
+
+// Drops every cached row and resizes the cache to `bytes`.
+void smo_set_cache_bytes(SmoSolver *s, size_t bytes) {
+    for (int i = 0; i < s->n; i++) {
+        free(s->rows[i]);
+        s->rows[i] = NULL;
+    }
+    size_t row_bytes = sizeof(float) * s->cap;
+    size_t rows = bytes / row_bytes;
+    if (rows < 2) rows = 2;
+    if (rows > (size_t)s->n) rows = s->n;
+    s->cache_bytes = bytes;
+    s->cache_rows = (int)rows;
+    s->cached = 0;
+    s->lru_prev[s->n] = s->lru_next[s->n] = s->n;
+    s->row_i = NULL;
+}
+
+// K(x_i, x_t) for every t (cap values, the padding is garbage). The
+// pointer stays valid until a row for two other points has been fetched.
+const float *smo_get_row(SmoSolver *s, int i) {
+    float *row = s->rows[i];
+    if (row) {
+        s->cache_hits++;
+        smo_cache_unlink(s, i);
+        smo_cache_push_front(s, i);
+        return row;
+    }
+
+    if (s->cached < s->cache_rows) {
+        row = malloc(sizeof(float) * s->cap);
+        s->cached++;
+    } else {
+        int victim = s->lru_prev[s->n];
+        smo_cache_unlink(s, victim);
+        row = s->rows[victim];
+        s->rows[victim] = NULL;
+    }
+    for (int d = 0; d < s->dim; d++) s->xq[d] = s->cols[(size_t)d * s->cap + i];
+    kernel_row(&s->kernel, s->xq, s->cols, s->cap, s->n, s->dim, row);
+    s->rows_computed++;
+    s->rows[i] = row;
+    smo_cache_push_front(s, i);
+    return row;
+}
+
+// ── Solver ──────────────────────────────────────────────────
+
+// X is row-major n x dim; it is copied, y is not. The row cache starts at
+// SMO_DEFAULT_CACHE_BYTES; call smo_set_cache_bytes() to change it.
+void smo_init(SmoSolver *s, const float *X, const int *y, int n, int dim, Kernel kernel, double C) {
+    *s = (SmoSolver){0};
+    s->n = n;
+    s->dim = dim;
+    s->cap = (n + 3) & ~3;
+    s->y = y;
+    s->kernel = kernel;
+    s->C = C;
+    s->eps = 1e-3;
+    s->max_iter = n > 100000 ? 100LL * n : 10000000LL;
+
+    s->cols = calloc((size_t)dim * s->cap, sizeof(float));
+    for (int i = 0; i < n; i++)
+        for (int d = 0; d < dim; d++)
+            s->cols[(size_t)d * s->cap + i] = X[(size_t)i * dim + d];
+
+    s->alpha = calloc(n, sizeof(double));
+    s->G = malloc(sizeof(double) * n);
+    s->diag = malloc(sizeof(float) * n);
+    s->xq = malloc(sizeof(float) * (dim > 0 ? dim : 1));
+    s->scratch = malloc(sizeof(float) * s->cap);
+    for (int i = 0; i < n; i++) {
+        s->G[i] = -1.0;
+        s->diag[i] = kernel_eval(&kernel, X + (size_t)i * dim, X + (size_t)i * dim, dim);
+    }
+
+    s->rows = calloc(n, sizeof(float *));
+    s->lru_prev = malloc(sizeof(int) * (n + 1));
+    s->lru_next = malloc(sizeof(int) * (n + 1));
+    smo_set_cache_bytes(s, SMO_DEFAULT_CACHE_BYTES);
+}
+
+void smo_free(SmoSolver *s) {
+    free(s->cols);
+    free(s->alpha);
+    free(s->G);
+    free(s->diag);
+    free(s->xq);
+    free(s->scratch);
+    for (int i = 0; i < s->n; i++) free(s->rows[i]);
+    free(s->rows);
+    free(s->lru_prev);
+    free(s->lru_next);
+    *s = (SmoSolver){0};
+}
+
+bool smo_in_up(const SmoSolver *s, int t) {
+    return s->y[t] > 0 ? s->alpha[t] < s->C : s->alpha[t] > 0;
+}
+
+bool smo_in_low(const SmoSolver *s, int t) {
+    return s->y[t] > 0 ? s->alpha[t] > 0 : s->alpha[t] < s->C;
+}
+
+// Second-order working set selection (Fan, Chen & Lin 2005). Returns false
+// when the current point is eps-optimal.
+bool smo_select(SmoSolver *s, int *out_i, int *out_j) {
+    double gmax = -INFINITY, gmax2 = -INFINITY;
+    int i = -1;
+    for (int t = 0; t < s->n; t++) {
+        if (smo_in_up(s, t) && -s->y[t] * s->G[t] >= gmax) {
+            gmax = -s->y[t] * s->G[t];
+            i = t;
+        }
+    }
+    if (i < 0) return false;
+
+    s->row_i = smo_get_row(s, i);
+    int j = -1;
+    double best = INFINITY;
+    for (int t = 0; t < s->n; t++) {
+        if (!smo_in_low(s, t)) continue;
+        double yg = s->y[t] * s->G[t];
+        if (yg > gmax2) gmax2 = yg;
+        double grad_diff = gmax + yg;
+        if (grad_diff > 0) {
+            double quad = (double)s->diag[i] + s->diag[t] - 2.0 * s->row_i[t];
+            if (quad <= 0) quad = SMO_TAU;
+            double obj = -(grad_diff * grad_diff) / quad;
+            if (obj <= best) {
+                best = obj;
+                j = t;
+            }
+        }
+    }
+
+    s->gap = gmax + gmax2;
+    if (s->gap < s->eps || j < 0) return false;
+    *out_i = i;
+    *out_j = j;
+    return true;
+}
+
+// Solves the two-variable subproblem for (i, j) and updates G.
+void smo_update(SmoSolver *s, int i, int j) {
+    const float *Ki = s->row_i, *Kj = smo_get_row(s, j);
+    double C = s->C;
+    double old_ai = s->alpha[i], old_aj = s->alpha[j];
+    double *ai = &s->alpha[i], *aj = &s->alpha[j];
+    int yi = s->y[i], yj = s->y[j];
+
+    double quad = (double)s->diag[i] + s->diag[j] - 2.0 * Ki[j];
+    if (quad <= 0) quad = SMO_TAU;
+
+    if (yi != yj) {
+        double delta = (-s->G[i] - s->G[j]) / quad;
+        double diff = *ai - *aj;
+        *ai += delta;
+        *aj += delta;
+        if (diff > 0) {
+            if (*aj < 0) { *aj = 0; *ai = diff; }
+        } else {
+            if (*ai < 0) { *ai = 0; *aj = -diff; }
+        }
+        if (diff > 0) {
+            if (*ai > C) { *ai = C; *aj = C - diff; }
+        } else {
+            if (*aj > C) { *aj = C; *ai = C + diff; }
+        }
+    } else {
+        double delta = (s->G[i] - s->G[j]) / quad;
+        double sum = *ai + *aj;
+        *ai -= delta;
+        *aj += delta;
+        if (sum > C) {
+            if (*ai > C) { *ai = C; *aj = sum - C; }
+        } else {
+            if (*aj < 0) { *aj = 0; *ai = sum; }
+        }
+        if (sum > C) {
+            if (*aj > C) { *aj = C; *ai = sum - C; }
+        } else {
+            if (*ai < 0) { *ai = 0; *aj = sum; }
+        }
+    }
+
+    // G_t += Q_ti da_i + Q_tj da_j
+    double di = (*ai - old_ai) * yi, dj = (*aj - old_aj) * yj;
+    for (int t = 0; t < s->n; t++)
+        s->G[t] += s->y[t] * (Ki[t] * di + Kj[t] * dj);
+}
+
+// Bias from the free vectors, or the middle of the feasible interval when
+// every vector is at a bound.
+void smo_compute_bias(SmoSolver *s) {
+    double ub = INFINITY, lb = -INFINITY, sum = 0;
+    int free_count = 0;
+    for (int t = 0; t < s->n; t++) {
+        double yg = s->y[t] * s->G[t];
+        if (s->alpha[t] > 0 && s->alpha[t] < s->C) {
+            sum += yg;
+            free_count++;
+        } else if ((s->alpha[t] >= s->C) != (s->y[t] > 0)) {
+            if (yg < ub) ub = yg;
+        } else {
+            if (yg > lb) lb = yg;
+        }
+    }
+    double rho = free_count > 0 ? sum / free_count : (ub + lb) / 2;
+    s->b = -rho;
+}
+
+// Runs up to `max_steps` iterations (all remaining if <= 0). Returns true
+// once converged, so callers can spread a solve over several frames.
+bool smo_run(SmoSolver *s, long long max_steps) {
+    long long steps = 0;
+    while (!s->converged && s->iter < s->max_iter && (max_steps <= 0 || steps < max_steps)) {
+        int i, j;
+        if (!smo_select(s, &i, &j)) {
+            s->converged = true;
+            break;
+        }
+        smo_update(s, i, j);
+        s->iter++;
+        steps++;
+    }
+    smo_compute_bias(s);
+    return s->converged;
+}
+
+int smo_support_count(const SmoSolver *s, int *bounded) {
+    int sv = 0, bsv = 0;
+    for (int t = 0; t < s->n; t++) {
+        if (s->alpha[t] > 0) sv++;
+        if (s->alpha[t] >= s->C) bsv++;
+    }
+    if (bounded) *bounded = bsv;
+    return sv;
+}
+
+// sum a_t y_t K(x_t, x) + b for a point x of dim values.
+double smo_decision(SmoSolver *s, const float *x) {
+    kernel_row(&s->kernel, x, s->cols, s->cap, s->n, s->dim, s->scratch);
+    double f = s->b;
+    for (int t = 0; t < s->n; t++)
+        if (s->alpha[t] > 0) f += s->alpha[t] * s->y[t] * s->scratch[t];
+    return f;
+}
+
+// Primal weights for the linear kernel: w = sum a_i y_i x_i.
+void smo_linear_weights(const SmoSolver *s, float *w) {
+    for (int d = 0; d < s->dim; d++) {
+        double sum = 0;
+        const float *col = s->cols + (size_t)d * s->cap;
+        for (int t = 0; t < s->n; t++)
+            if (s->alpha[t] > 0) sum += s->alpha[t] * s->y[t] * col[t];
+        w[d] = (float)sum;
+    }
+}
+
+// Dual objective 1/2 a'Qa - e'a, from the gradient: a'(G - e) / 2.
+double smo_dual_objective(const SmoSolver *s) {
+    double obj = 0;
+    for (int t = 0; t < s->n; t++) obj += s->alpha[t] * (s->G[t] - 1.0);
+    return obj / 2;
+}
+
+#endif
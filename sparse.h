@@ -0,0 +1,253 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+// Sparse inputs for the Perceptron. Include nob.h and perceptron.h first.
+//
+// A SparseDataset stores its samples in CSR form: the index/value pairs of
+// row i are idx/val[row_ptr[i] .. row_ptr[i + 1]). Predict and train touch
+// only those pairs, so an epoch costs O(nonzeros) whatever the dimension.
+//
+// Momentum, Nesterov and Adam update their state lazily: a weight's moments
+// only move on samples where its feature is present (the usual "lazy"
+// sparse variants). The bias is always updated.
+//
+// Feature hashing maps tokens straight to indices in a power-of-two space
+// (FNV-1a, with one hash bit choosing the sign so collisions cancel out in
+// expectation), so no vocabulary is kept.
+
+#include <ctype.h>
+#include <stdint.h>
+
+typedef struct {
+    int *items;
+    size_t count;
+    size_t capacity;
+} SparseIndices;
+
+typedef struct {
+    float *items;
+    size_t count;
+    size_t capacity;
+} SparseValues;
+
+typedef struct {
+    char name[32];
+    int dim;                // size of the feature space
+    int count;              // rows
+    SparseIndices row_ptr;  // count + 1 offsets into idx/val
+    SparseIndices idx;
+    SparseValues val;
+    SparseValues label;
+} SparseDataset;
+
+void sparse_init(SparseDataset *ds, const char *name, int dim) {
+    *ds = (SparseDataset){0};
+    snprintf(ds->name, sizeof(ds->name), "%s", name);
+    ds->dim = dim;
+    da_append(&ds->row_ptr, 0);
+}
+
+void sparse_free(SparseDataset *ds) {
+    da_free(ds->row_ptr);
+    da_free(ds->idx);
+    da_free(ds->val);
+    da_free(ds->label);
+    *ds = (SparseDataset){0};
+}
+
+size_t sparse_nnz(const SparseDataset *ds) {
+    return ds->idx.count;
+}
+
+// Appends one row from n index/value pairs. Duplicate indices are summed
+// and the row is sorted by index.
+void sparse_add_row(SparseDataset *ds, const int *idx, const float *val, int n, float label) {
+    size_t start = ds->idx.count;
+    for (int k = 0; k < n; k++) {
+        if (idx[k] < 0 || idx[k] >= ds->dim || val[k] == 0.0f) continue;
+        // Insertion into the (short) sorted row
+        size_t pos = ds->idx.count;
+        while (pos > start && ds->idx.items[pos - 1] > idx[k]) pos--;
+        if (pos > start && ds->idx.items[pos - 1] == idx[k]) {
+            ds->val.items[pos - 1] += val[k];
+            continue;
+        }
+        da_append(&ds->idx, 0);
+        da_append(&ds->val, 0.0f);
+        memmove(ds->idx.items + pos + 1, ds->idx.items + pos,
+                sizeof(int) * (ds->idx.count - 1 - pos));
+        memmove(ds->val.items + pos + 1, ds->val.items + pos,
+                sizeof(float) * (ds->val.count - 1 - pos));
+        ds->idx.items[pos] = idx[k];
+        ds->val.items[pos] = val[k];
+    }
+    da_append(&ds->row_ptr, (int)ds->idx.count);
+    da_append(&ds->label, label);
+    ds->count++;
+}
+
+// ── Feature hashing ─────────────────────────────────────────
+
+uint32_t fnv1a(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Index in [0, dim) and a +-1 sign for one feature name. dim must be a
+// power of two.
+int hash_feature(const char *s, size_t len, int dim, float *sign) {
+    uint32_t h = fnv1a(s, len);
+    *sign = (h >> 31) ? -1.0f : 1.0f;
+    return (int)(h & (uint32_t)(dim - 1));
+}
+
+#define SPARSE_MAX_TOKENS 4096
+#define SPARSE_MAX_TOKEN  64
+
+// Hashes the lowercased alphanumeric words of `text` into a row, then
+// scales it to unit L2 norm so the learning rate does not depend on the
+// document length.
+void sparse_add_text(SparseDataset *ds, const char *text, float label) {
+    int idx[SPARSE_MAX_TOKENS];
+    float val[SPARSE_MAX_TOKENS];
+    int n = 0;
+
+    const char *s = text;
+    while (*s && n < SPARSE_MAX_TOKENS) {
+        while (*s && !isalnum((unsigned char)*s)) s++;
+        char word[SPARSE_MAX_TOKEN];
+        size_t len = 0;
+        while (*s && isalnum((unsigned char)*s)) {
+            if (len < sizeof(word)) word[len++] = (char)tolower((unsigned char)*s);
+            s++;
+        }
+        if (len == 0) break;
+        idx[n] = hash_feature(word, len, ds->dim, &val[n]);
+        n++;
+    }
+
+    size_t start = ds->idx.count;
+    sparse_add_row(ds, idx, val, n, label);
+    float sq = 0;
+    for (size_t k = start; k < ds->idx.count; k++) sq += ds->val.items[k] * ds->val.items[k];
+    if (sq > 0) {
+        float inv = 1.0f / sqrtf(sq);
+        for (size_t k = start; k < ds->idx.count; k++) ds->val.items[k] *= inv;
+    }
+}
+
+// ── Kernels ─────────────────────────────────────────────────
+
+float sparse_dot(const float *w, const int *idx, const float *val, int nnz) {
+    float sum = 0;
+    for (int k = 0; k < nnz; k++)
+        sum += w[idx[k]] * val[k];
+    return sum;
+}
+
+// w[idx[k]] += scale * val[k]
+void sparse_axpy(float *w, const int *idx, const float *val, int nnz, float scale) {
+    for (int k = 0; k < nnz; k++)
+        w[idx[k]] += scale * val[k];
+}
+
+float predict_sparse(const Perceptron *p, const SparseDataset *ds, int i) {
+    int begin = ds->row_ptr.items[i], end = ds->row_ptr.items[i + 1];
+    return activation_fn(p->b + sparse_dot(p->w, ds->idx.items + begin,
+                                           ds->val.items + begin, end - begin));
+}
+
+// Hashed features start from zero weights rather than init_perceptron()'s
+// random ones, which would give every bucket a random vote.
+void init_perceptron_sparse(Perceptron *p, int dim) {
+    init_perceptron(p, dim);
+    memset(p->w, 0, sizeof(float) * dim);
+    p->b = 0;
+}
+
+// One online epoch over a sparse dataset, same rules as train_step().
+void train_step_sparse(Perceptron *p, const Optimizer *opt, const SparseDataset *ds,
+                       float *mse) {
+    float lr = optimizer_lr(opt, p->epoch);
+    float mu = opt->momentum;
+    float b1 = opt->beta1, b2 = opt->beta2;
+    float total_error = 0;
+
+    for (int i = 0; i < ds->count; i++) {
+        int begin = ds->row_ptr.items[i];
+        int nnz = ds->row_ptr.items[i + 1] - begin;
+        const int *idx = ds->idx.items + begin;
+        const float *val = ds->val.items + begin;
+
+        float output = activation_fn(p->b + sparse_dot(p->w, idx, val, nnz));
+        float error = output - ds->label.items[i];
+        total_error += error * error;
+        p->t++;
+
+        switch (opt->kind) {
+            case OPT_SGD:
+                sparse_axpy(p->w, idx, val, nnz, -lr * error);
+                p->b -= lr * error;
+                break;
+            case OPT_MOMENTUM:
+                for (int k = 0; k < nnz; k++) {
+                    int j = idx[k];
+                    p->m[j] = mu * p->m[j] + error * val[k];
+                    p->w[j] -= lr * p->m[j];
+                }
+                p->mb = mu * p->mb + error;
+                p->b -= lr * p->mb;
+                break;
+            case OPT_NESTEROV:
+                for (int k = 0; k < nnz; k++) {
+                    int j = idx[k];
+                    float g = error * val[k];
+                    p->m[j] = mu * p->m[j] + g;
+                    p->w[j] -= lr * (g + mu * p->m[j]);
+                }
+                p->mb = mu * p->mb + error;
+                p->b -= lr * (error + mu * p->mb);
+                break;
+            case OPT_ADAM: {
+                p->beta1_t *= b1;
+                p->beta2_t *= b2;
+                float step = lr * sqrtf(1.0f - p->beta2_t) / (1.0f - p->beta1_t);
+                for (int k = 0; k < nnz; k++) {
+                    int j = idx[k];
+                    float g = error * val[k];
+                    p->m[j] = b1 * p->m[j] + (1.0f - b1) * g;
+                    p->v[j] = b2 * p->v[j] + (1.0f - b2) * g * g;
+                    p->w[j] -= step * p->m[j] / (sqrtf(p->v[j]) + opt->eps);
+                }
+                p->mb = b1 * p->mb + (1.0f - b1) * error;
+                p->vb = b2 * p->vb + (1.0f - b2) * error * error;
+                p->b -= step * p->mb / (sqrtf(p->vb) + opt->eps);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    *mse = ds->count ? total_error / (float)ds->count : 0.0f;
+    p->epoch++;
+    p->version++;
+}
+
+// Copies a sparse dataset into dense rows (for comparisons on small dims).
+bool sparse_to_dense(const SparseDataset *sds, DatasetInfo *out) {
+    if (!alloc_dataset(out, sds->name, sds->count, sds->dim)) return false;
+    for (int i = 0; i < sds->count; i++) {
+        float *row = dataset_row(out, i);
+        for (int k = sds->row_ptr.items[i]; k < sds->row_ptr.items[i + 1]; k++)
+            row[sds->idx.items[k]] = sds->val.items[k];
+        row[sds->dim] = sds->label.items[i];
+    }
+    compute_dataset_bounds(out);
+    return true;
+}
+
+#endif
@@ -15,6 +15,15 @@
 
 #include "anim.h"
 #include "iris.h"
+#include "converge.h"
+#include "kernel.h"
+#include "smo.h"
+#include "dcd.h"
+#include "pool.h"
+#include "multiclass.h"
+#include "pegasos.h"
+#include "search.h"
+#include "incremental.h"
 
 #define WIDTH 1920
 #define HEIGHT 1024
@@ -31,6 +40,7 @@
 
 TweenEngine te;
 float lr = 0.0001;
+float lambda = 1.0f;    // regularization strength in train()
 bool is_training = false;
 float delta = 0.01;
 
@@ -72,27 +82,51 @@ typedef enum {
 
 VIEW_MODE view_mode = VIEW_3D;
 
+// A dataset is split by who reads it. Sample is the hot part that
+// training and evaluation stream: the two trained features, the class and
+// the label, 16 bytes so four share a cache line and compute_stats() loads
+// each one as a single vector. Visual holds everything only drawing and
+// tweening touch, in a parallel array kept in sync by index.
 typedef struct {
     Vector3 pos;
     Color color;
     float radius;
+    float y;                // third feature: the 3D view's height, never trained on
+    bool user;              // added by a click, drawn as a cube
 } Visual;
 
 typedef struct {
     float x;
-    float y;
     float z;
+    int class;              // +1 / -1 for the binary SVM
     IRIS_LABEL label;
-    int class;
-    Visual vis;
 } Sample;
 
+_Static_assert(sizeof(Sample) == 4 * sizeof(float), "compute_stats() loads a Sample as one vector");
+
 typedef struct {
     size_t capacity;
     size_t count;
     Sample *items;
+    Visual *vis;            // vis[i] draws items[i]
+    size_t vis_capacity;
 } Dataset;
 
+void dataset_append(Dataset *ds, Sample sample, Visual vis) {
+    da_append(ds, sample);
+    if (ds->vis_capacity < ds->capacity) {
+        ds->vis_capacity = ds->capacity;
+        ds->vis = realloc(ds->vis, sizeof(Visual) * ds->vis_capacity);
+    }
+    ds->vis[ds->count - 1] = vis;
+}
+
+void dataset_free(Dataset *ds) {
+    free(ds->items);
+    free(ds->vis);
+    *ds = (Dataset){0};
+}
+
 
 Color FEATURES_COLORS[CLASS_COUNT] = {
     COLOR_GRAY,
@@ -137,11 +171,10 @@ float get_dist(DIST_METRIC metric, Vector3 a, Vector3 b) {
 void generate_points(Dataset *dataset)
 {
     reset_points(dataset);
-    Sample* points = dataset->items;
     for (int i = 0; i < dataset->capacity; i++)
     {
-        Sample pt = (Sample){.x = randf(0, WIDTH), .y = randf(0, HEIGHT), .z = randf(0, WIDTH), .label = UNKNOWN};
-        da_append(dataset, pt);
+        Sample pt = (Sample){.x = randf(0, WIDTH), .z = randf(0, WIDTH), .label = UNKNOWN};
+        dataset_append(dataset, pt, (Visual){.y = randf(0, HEIGHT)});
     }
 }
 
@@ -189,20 +222,19 @@ void draw_axes(VIEW_MODE view_mode) {
 
 void draw_dataset(const Dataset *td, float dt, bool is_training_set){
     for (int i = 0; i < td->count; i++){
-        Sample entry = td->items[i];
-        Visual vis = entry.vis; 
+        Visual vis = td->vis[i]; 
         Vector3 pos = vis.pos; 
         float r = vis.radius; 
         Color color = vis.color; 
         if (view_mode == VIEW_2D)
             pos.y = 0;
 
-        if (is_training_set) {
+        if (is_training_set && !vis.user) {
             DrawSphere(pos, r, color);
         } else {
             float size = r * 1.2f;
             DrawCube(pos, size, size, size, color);
-            if (entry.label == UNKNOWN) {
+            if (td->items[i].label == UNKNOWN) {
                 float pulse = 1.0f + 0.2f * sinf(GetTime() * 4.0f);
                 float ps = size * 1.5f * pulse;
                 DrawCube(pos, ps, ps, ps, (Color){255, 255, 255, 60});
@@ -237,7 +269,8 @@ void prepare_training_dataset(Dataset *td){
     for(int i = 0; i < IRIS.count; i++){
         Row row = IRIS.data[i];
         IRIS_LABEL label = map_label(row.variety);
-        if (label == VERSICOLOR) continue;
+        // The binary SVM separates setosa from the rest; the multiclass
+        // model uses the labels directly
         int class = label == SETOSA ? 1 : -1;
 
         float s_l = (row.sepal_length / max_sepal_length) / 10;
@@ -246,30 +279,32 @@ void prepare_training_dataset(Dataset *td){
         float p_w = (row.petal_width  / max_petal_width ) * 10.0f - 5.0f;
 
         Sample sample = (Sample){ 
-            .x = p_w, .y = p_l, .z = s_w,
-            .label = label, 
+            .x = p_w, .z = s_w,
             .class = class, 
-            .vis = { 
-                .pos = random_vec3(),
-                .radius = 0, 
-                .color = WHITE
-            }
+            .label = label, 
         };
-        da_append(td, sample);
+        Visual vis = (Visual){ 
+            .pos = random_vec3(),
+            .radius = 0, 
+            .color = WHITE,
+            .y = p_l
+        };
+        dataset_append(td, sample, vis);
 
         int idx = td->count - 1;
         float dur = 1.0;
         Color color = FEATURES_COLORS[label];
-        tween_vec3(&te, &td->items[idx].vis.pos, 
+        tween_vec3(&te, &td->vis[idx].pos, 
                 (Vector3){ .x = p_w, .y = p_l, .z = s_w }, dur);
-        tween_float(&te, &td->items[idx].vis.radius, s_l, dur);
-        tween_color(&te, &td->items[idx].vis.color, color, dur);
+        tween_float(&te, &td->vis[idx].radius, s_l, dur);
+        tween_color(&te, &td->vis[idx].color, color, dur);
     }
 }
 
 void draw_classes(){
     DrawText("SETOSA", WIDTH-150, 20, 20, FEATURES_COLORS[SETOSA]);
     DrawText("VIRGINICA", WIDTH-150, 40, 20, FEATURES_COLORS[VIRGINICA]);
+    DrawText("VERSICOLOR", WIDTH-150, 60, 20, FEATURES_COLORS[VERSICOLOR]);
 }
 
 void draw_axis_labels(const Camera *camera, VIEW_MODE view_mode) {
@@ -302,14 +337,14 @@ void toggle_view_anim(Dataset *ds, Camera *camera, VIEW_MODE *view_mode) {
     cam_look_at(camera, (Vector3){ 0, 0, 0 });
     if (*view_mode == VIEW_3D) {
         for (int i = 0; i < ds->count; i++) {
-            tween_vec3(&te, &ds->items[i].vis.pos, 
-                    (Vector3){ ds->items[i].x, ds->items[i].y, ds->items[i].z }, 1.0f);
+            tween_vec3(&te, &ds->vis[i].pos, 
+                    (Vector3){ ds->items[i].x, ds->vis[i].y, ds->items[i].z }, 1.0f);
         }
         cam_look_at(camera, (Vector3){ 0, 0, 0 });
         cam_move(camera, (Vector3){ 10, 10, 10 });
     } else {
         for (int i = 0; i < ds->count; i++) {
-            tween_vec3(&te, &ds->items[i].vis.pos,
+            tween_vec3(&te, &ds->vis[i].pos,
                     (Vector3){ ds->items[i].x, 0, ds->items[i].z }, 1.0f);
         }
         cam_move(camera, (Vector3){ 0.0, 18, 0.01 });
@@ -332,12 +367,12 @@ void train(Dataset *dataset, SVM *svm){
 
         if (margin >= 1){
             // correctly classified with enough margin — just shrink weights
-            w1 -= lr * w1;
-            w2 -= lr * w2;
+            w1 -= lr * lambda * w1;
+            w2 -= lr * lambda * w2;
         } else {
             // misclassified or inside margin — push boundary
-            w1 -= lr * (w1 - yi * x1);
-            w2 -= lr * (w2 - yi * x2);
+            w1 -= lr * (lambda * w1 - yi * x1);
+            w2 -= lr * (lambda * w2 - yi * x2);
             b  -= lr * (-yi);
         }
     }
@@ -347,93 +382,194 @@ void train(Dataset *dataset, SVM *svm){
     svm->b  = b;
 }
 
-void draw_svm(const SVM *svm, VIEW_MODE view_mode) {
-    float w1 = svm->w1;
-    float w2 = svm->w2;
-    float b  = svm->b;
+// ── Pegasos ─────────────────────────────────────────────────
+
+// Alternative to train(): one mini-batch Pegasos epoch per frame on the
+// same (x, z) features, lambda = 1/n so it minimizes the loss on screen.
+// The schedule starts at t0 = 1/lambda (first step ~1): plain 1/(lambda t)
+// overshoots to ~10x the optimal weights on this data and then crawls back.
+// A batch of PEGASOS_BATCH rows fits in one PEGASOS_CHUNK, so the epoch runs
+// without the pool: the ~150 samples here would not keep a second core busy.
+#define PEGASOS_BATCH 16
+
+Pegasos pegasos = {0};
+bool use_pegasos = false;
+float *pegasos_X = NULL;
+int *pegasos_y = NULL;
+int pegasos_n = 0;          // rows copied into pegasos_X
+
+void pegasos_reset(const Dataset *ds) {
+    int n = (int)ds->count;
+    pegasos_X = realloc(pegasos_X, sizeof(float) * 2 * (n > 0 ? n : 1));
+    pegasos_y = realloc(pegasos_y, sizeof(int) * (n > 0 ? n : 1));
+    for (int i = 0; i < n; i++) {
+        pegasos_X[2 * i] = ds->items[i].x;
+        pegasos_X[2 * i + 1] = ds->items[i].z;
+        pegasos_y[i] = ds->items[i].class;
+    }
+    pegasos_free(&pegasos);
+    pegasos_init(&pegasos, 2, n > 0 ? 1.0f / n : 1.0f, PEGASOS_BATCH, true);
+    pegasos.t0 = 1.0f / pegasos.lambda;
+    pegasos_n = n;
+}
+
+// Starts from the current parameters, so manual nudges carry over.
+void train_pegasos(const Dataset *ds, SVM *svm) {
+    // User points may have arrived since the copy was taken
+    if (!pegasos.w || pegasos_n != (int)ds->count) pegasos_reset(ds);
+    pegasos.w[0] = svm->w1;
+    pegasos.w[1] = svm->w2;
+    pegasos.b = svm->b;
+    pegasos_epoch(&pegasos, pegasos_X, pegasos_y, (int)ds->count, NULL);
+    svm->w1 = pegasos.w[0];
+    svm->w2 = pegasos.w[1];
+    svm->b = pegasos.b;
+}
+
+// ── Plane meshes ────────────────────────────────────────────
+
+// The decision plane, the two margin planes and the 2D margin band live in
+// dynamic meshes. Their vertices are rebuilt only when svm_visual has moved
+// by more than PLANE_EPS since the last build (or the view changed), and
+// each surface is one DrawModel() call. Every quad is indexed with both
+// windings so it shows from either side.
+#define PLANE_EPS 1e-4f
+#define PLANE_X0 -5.0f
+#define PLANE_X1  5.0f
+#define PLANE_Y0 -5.0f
+#define PLANE_Y1  5.0f
+
+typedef struct {
+    Model decision;         // 3D: w.x + b = 0
+    Model margins;          // 3D: w.x + b = +1 and -1
+    Model band;             // 2D: the strip between the margin lines
+    Vector3 edges[3][4];    // 3D outline of decision, +1, -1
+    Vector3 lines[3][2];    // 2D decision, +1, -1 lines
+    SVM built;
+    VIEW_MODE built_view;
+    bool loaded;
+    bool valid;             // vertices match `built`
+    bool visible;           // w2 is large enough to draw
+} SvmPlanes;
+
+SvmPlanes planes = {0};
+
+Model make_quad_model(int quads) {
+    Mesh mesh = {0};
+    mesh.vertexCount = quads * 4;
+    mesh.triangleCount = quads * 4;
+    mesh.vertices = MemAlloc(sizeof(float) * 3 * mesh.vertexCount);
+    mesh.indices = MemAlloc(sizeof(unsigned short) * 3 * mesh.triangleCount);
+    static const unsigned short QUAD[12] = {0, 1, 2, 0, 2, 3, 2, 1, 0, 3, 2, 0};
+    for (int q = 0; q < quads; q++)
+        for (int k = 0; k < 12; k++)
+            mesh.indices[q * 12 + k] = (unsigned short)(q * 4 + QUAD[k]);
+    UploadMesh(&mesh, true);
+    return LoadModelFromMesh(mesh);
+}
+
+void set_quad(Mesh *mesh, int q, const Vector3 corners[4]) {
+    for (int k = 0; k < 4; k++) {
+        mesh->vertices[(q * 4 + k) * 3 + 0] = corners[k].x;
+        mesh->vertices[(q * 4 + k) * 3 + 1] = corners[k].y;
+        mesh->vertices[(q * 4 + k) * 3 + 2] = corners[k].z;
+    }
+}
+
+void upload_quads(Model *model) {
+    Mesh *mesh = &model->meshes[0];
+    UpdateMeshBuffer(*mesh, 0, mesh->vertices, sizeof(float) * 3 * mesh->vertexCount, 0);
+}
 
-    if (fabsf(w1) < 0.0001f && fabsf(w2) < 0.0001f) return;
-    if (fabsf(w2) < 0.0001f) return;
+bool planes_stale(const SVM *svm, VIEW_MODE view_mode) {
+    return !planes.valid || planes.built_view != view_mode ||
+           fabsf(planes.built.w1 - svm->w1) > PLANE_EPS ||
+           fabsf(planes.built.w2 - svm->w2) > PLANE_EPS ||
+           fabsf(planes.built.b - svm->b) > PLANE_EPS;
+}
 
-    float x0 = -5.0f, x1 = 5.0f;
+void build_planes(const SVM *svm, VIEW_MODE view_mode) {
+    float w1 = svm->w1, w2 = svm->w2, b = svm->b;
+    planes.built = *svm;
+    planes.built_view = view_mode;
+    planes.valid = true;
+    planes.visible = fabsf(w2) >= 0.0001f;
+    if (!planes.visible) return;
+
+    // z where w1 x + w2 z + b = offset
+    float offsets[3] = {0.0f, 1.0f, -1.0f};
+    float z0[3], z1[3];
+    for (int k = 0; k < 3; k++) {
+        z0[k] = -(w1 * PLANE_X0 + b - offsets[k]) / w2;
+        z1[k] = -(w1 * PLANE_X1 + b - offsets[k]) / w2;
+    }
 
     if (view_mode == VIEW_3D) {
-        float y0 = -5.0f, y1 = 5.0f;
+        for (int k = 0; k < 3; k++) {
+            planes.edges[k][0] = (Vector3){PLANE_X0, PLANE_Y0, z0[k]};
+            planes.edges[k][1] = (Vector3){PLANE_X1, PLANE_Y0, z1[k]};
+            planes.edges[k][2] = (Vector3){PLANE_X1, PLANE_Y1, z1[k]};
+            planes.edges[k][3] = (Vector3){PLANE_X0, PLANE_Y1, z0[k]};
+        }
+        set_quad(&planes.decision.meshes[0], 0, planes.edges[0]);
+        set_quad(&planes.margins.meshes[0], 0, planes.edges[1]);
+        set_quad(&planes.margins.meshes[0], 1, planes.edges[2]);
+        upload_quads(&planes.decision);
+        upload_quads(&planes.margins);
+    } else {
+        for (int k = 0; k < 3; k++) {
+            planes.lines[k][0] = (Vector3){PLANE_X0, 0, z0[k]};
+            planes.lines[k][1] = (Vector3){PLANE_X1, 0, z1[k]};
+        }
+        Vector3 band[4] = {
+            planes.lines[2][0], planes.lines[2][1], planes.lines[1][1], planes.lines[1][0]
+        };
+        set_quad(&planes.band.meshes[0], 0, band);
+        upload_quads(&planes.band);
+    }
+}
+
+void unload_planes(void) {
+    if (!planes.loaded) return;
+    UnloadModel(planes.decision);
+    UnloadModel(planes.margins);
+    UnloadModel(planes.band);
+    planes = (SvmPlanes){0};
+}
+
+void draw_svm(const SVM *svm, VIEW_MODE view_mode) {
+    if (!planes.loaded) {
+        planes.decision = make_quad_model(1);
+        planes.margins = make_quad_model(2);
+        planes.band = make_quad_model(1);
+        planes.loaded = true;
+    }
+    if (planes_stale(svm, view_mode))
+        build_planes(svm, view_mode);
+    if (!planes.visible) return;
+
+    Vector3 origin = {0, 0, 0};
+    if (view_mode == VIEW_3D) {
         Color margin_fill = (Color){88, 196, 221, 20};
         Color decision_fill = (Color){255, 255, 255, 12};
         Color edge = (Color){88, 196, 221, 80};
         Color edge_w = (Color){255, 255, 255, 50};
 
-        // decision plane (w1*x + w2*z + b = 0)
-        Vector3 d_a = {x0, y0, -(w1*x0 + b) / w2};
-        Vector3 d_b = {x1, y0, -(w1*x1 + b) / w2};
-        Vector3 d_c = {x1, y1, -(w1*x1 + b) / w2};
-        Vector3 d_d = {x0, y1, -(w1*x0 + b) / w2};
-        DrawTriangle3D(d_a, d_b, d_c, decision_fill);
-        DrawTriangle3D(d_a, d_c, d_d, decision_fill);
-        DrawTriangle3D(d_c, d_b, d_a, decision_fill);
-        DrawTriangle3D(d_d, d_c, d_a, decision_fill);
-        DrawLine3D(d_a, d_b, edge_w);
-        DrawLine3D(d_b, d_c, edge_w);
-        DrawLine3D(d_c, d_d, edge_w);
-        DrawLine3D(d_d, d_a, edge_w);
-
-        // margin +1
-        Vector3 mp_a = {x0, y0, -(w1*x0 + b - 1.0f) / w2};
-        Vector3 mp_b = {x1, y0, -(w1*x1 + b - 1.0f) / w2};
-        Vector3 mp_c = {x1, y1, -(w1*x1 + b - 1.0f) / w2};
-        Vector3 mp_d = {x0, y1, -(w1*x0 + b - 1.0f) / w2};
-        DrawTriangle3D(mp_a, mp_b, mp_c, margin_fill);
-        DrawTriangle3D(mp_a, mp_c, mp_d, margin_fill);
-        DrawTriangle3D(mp_c, mp_b, mp_a, margin_fill);
-        DrawTriangle3D(mp_d, mp_c, mp_a, margin_fill);
-        DrawLine3D(mp_a, mp_b, edge);
-        DrawLine3D(mp_b, mp_c, edge);
-        DrawLine3D(mp_c, mp_d, edge);
-        DrawLine3D(mp_d, mp_a, edge);
-
-        // margin -1
-        Vector3 mm_a = {x0, y0, -(w1*x0 + b + 1.0f) / w2};
-        Vector3 mm_b = {x1, y0, -(w1*x1 + b + 1.0f) / w2};
-        Vector3 mm_c = {x1, y1, -(w1*x1 + b + 1.0f) / w2};
-        Vector3 mm_d = {x0, y1, -(w1*x0 + b + 1.0f) / w2};
-        DrawTriangle3D(mm_a, mm_b, mm_c, margin_fill);
-        DrawTriangle3D(mm_a, mm_c, mm_d, margin_fill);
-        DrawTriangle3D(mm_c, mm_b, mm_a, margin_fill);
-        DrawTriangle3D(mm_d, mm_c, mm_a, margin_fill);
-        DrawLine3D(mm_a, mm_b, edge);
-        DrawLine3D(mm_b, mm_c, edge);
-        DrawLine3D(mm_c, mm_d, edge);
-        DrawLine3D(mm_d, mm_a, edge);
-
-    } else {
-        // decision line
-        DrawLine3D(
-            (Vector3){x0, 0, -(w1*x0 + b) / w2},
-            (Vector3){x1, 0, -(w1*x1 + b) / w2}, WHITE);
-        // margin lines
-        DrawLine3D(
-            (Vector3){x0, 0, -(w1*x0 + b - 1.0f) / w2},
-            (Vector3){x1, 0, -(w1*x1 + b - 1.0f) / w2}, COLOR_BLUE);
-        DrawLine3D(
-            (Vector3){x0, 0, -(w1*x0 + b + 1.0f) / w2},
-            (Vector3){x1, 0, -(w1*x1 + b + 1.0f) / w2}, COLOR_BLUE);
-
-        // margin fill
-        int steps = 50;
-        Color fill = (Color){255, 255, 255, 15};
-        for (int i = 0; i < steps; i++) {
-            float xi = x0 + (x1 - x0) * i / steps;
-            float xn = x0 + (x1 - x0) * (i + 1) / steps;
-            float z_p  = -(w1*xi + b + 1.0f) / w2;
-            float z_m  = -(w1*xi + b - 1.0f) / w2;
-            float z_pn = -(w1*xn + b + 1.0f) / w2;
-            float z_mn = -(w1*xn + b - 1.0f) / w2;
-            DrawTriangle3D((Vector3){xi,0,z_p}, (Vector3){xn,0,z_pn}, (Vector3){xn,0,z_mn}, fill);
-            DrawTriangle3D((Vector3){xi,0,z_p}, (Vector3){xn,0,z_mn}, (Vector3){xi,0,z_m},  fill);
-            DrawTriangle3D((Vector3){xn,0,z_mn}, (Vector3){xn,0,z_pn}, (Vector3){xi,0,z_p}, fill);
-            DrawTriangle3D((Vector3){xi,0,z_m},  (Vector3){xn,0,z_mn}, (Vector3){xi,0,z_p}, fill);
+        DrawModel(planes.decision, origin, 1.0f, decision_fill);
+        DrawModel(planes.margins, origin, 1.0f, margin_fill);
+        for (int k = 0; k < 3; k++) {
+            const Vector3 *e = planes.edges[k];
+            Color c = k == 0 ? edge_w : edge;
+            DrawLine3D(e[0], e[1], c);
+            DrawLine3D(e[1], e[2], c);
+            DrawLine3D(e[2], e[3], c);
+            DrawLine3D(e[3], e[0], c);
         }
+    } else {
+        DrawModel(planes.band, origin, 1.0f, (Color){255, 255, 255, 15});
+        DrawLine3D(planes.lines[0][0], planes.lines[0][1], WHITE);
+        DrawLine3D(planes.lines[1][0], planes.lines[1][1], COLOR_BLUE);
+        DrawLine3D(planes.lines[2][0], planes.lines[2][1], COLOR_BLUE);
     }
 }
 
@@ -449,34 +585,380 @@ void svm_icr_w2(SVM *svm, float delta){
     svm->w2 += delta;
 }
 
-float compute_accuracy(const Dataset *ds, const SVM *svm) {
-    int correct = 0;
-    for (int i = 0; i < ds->count; i++) {
-        Sample s = ds->items[i];
-        float prediction = svm->w1 * s.x + svm->w2 * s.z + svm->b;
-        int predicted_class = prediction >= 0 ? 1 : -1;
-        if (predicted_class == s.class) correct++;
+// Everything the HUD reports about the current parameters, from one pass.
+typedef struct {
+    float loss;             // (1/2 |w|^2 + sum hinge) / n
+    float accuracy;
+    float min_margin;       // smallest y (w.x + b)
+    int inside_margin;      // 0 <= y (w.x + b) < 1
+    int misclassified;      // predicted class differs (f >= 0 is class +1)
+} SvmStats;
+
+// Hinge loss, accuracy and margin counts in a single SSE pass over the
+// samples, four at a time: four 16-byte rows loaded whole and transposed
+// into x, z, class and label lanes.
+SvmStats compute_stats(const Dataset *ds, const SVM *svm) {
+    SvmStats st = {.min_margin = INFINITY};
+    int n = (int)ds->count;
+    if (n == 0) return (SvmStats){0};
+    const Sample *items = ds->items;
+    float hinge_sum = 0;
+    int i = 0;
+#if defined(__SSE2__)
+    __m128 w1 = _mm_set1_ps(svm->w1), w2 = _mm_set1_ps(svm->w2), b = _mm_set1_ps(svm->b);
+    __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+    __m128 hinge_acc = zero, min_acc = _mm_set1_ps(INFINITY);
+    __m128i inside_acc = _mm_setzero_si128(), wrong_acc = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        const float *row = (const float *)(items + i);
+        __m128 x = _mm_loadu_ps(row), z = _mm_loadu_ps(row + 4);
+        __m128 cls = _mm_loadu_ps(row + 8), label = _mm_loadu_ps(row + 12);
+        _MM_TRANSPOSE4_PS(x, z, cls, label);
+        __m128 y = _mm_cvtepi32_ps(_mm_castps_si128(cls));
+        __m128 f = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w1, x), _mm_mul_ps(w2, z)), b);
+        __m128 margin = _mm_mul_ps(y, f);
+        hinge_acc = _mm_add_ps(hinge_acc, _mm_max_ps(zero, _mm_sub_ps(one, margin)));
+        min_acc = _mm_min_ps(min_acc, margin);
+        // Compare masks are -1 per true lane, so subtracting counts them
+        __m128 inside = _mm_and_ps(_mm_cmpge_ps(margin, zero), _mm_cmplt_ps(margin, one));
+        __m128 wrong = _mm_xor_ps(_mm_cmpge_ps(f, zero), _mm_cmpgt_ps(y, zero));
+        inside_acc = _mm_sub_epi32(inside_acc, _mm_castps_si128(inside));
+        wrong_acc = _mm_sub_epi32(wrong_acc, _mm_castps_si128(wrong));
+    }
+    hinge_sum = hsum_ps(hinge_acc);
+    float mins[4];
+    int inside[4], wrong[4];
+    _mm_storeu_ps(mins, min_acc);
+    _mm_storeu_si128((__m128i *)inside, inside_acc);
+    _mm_storeu_si128((__m128i *)wrong, wrong_acc);
+    for (int k = 0; k < 4; k++) {
+        if (mins[k] < st.min_margin) st.min_margin = mins[k];
+        st.inside_margin += inside[k];
+        st.misclassified += wrong[k];
+    }
+#endif
+    for (; i < n; i++) {
+        const Sample *s = &items[i];
+        float f = svm->w1 * s->x + svm->w2 * s->z + svm->b;
+        float margin = s->class * f;
+        if (margin < 1.0f) hinge_sum += 1.0f - margin;
+        if (margin < st.min_margin) st.min_margin = margin;
+        if (margin >= 0 && margin < 1.0f) st.inside_margin++;
+        if ((f >= 0) != (s->class > 0)) st.misclassified++;
     }
-    return (float)correct / ds->count;
+
+    st.loss = (0.5f * (svm->w1 * svm->w1 + svm->w2 * svm->w2) + hinge_sum) / n;
+    st.accuracy = (float)(n - st.misclassified) / n;
+    return st;
 }
 
-float compute_loss(const Dataset *ds, const SVM *svm) {
-    float loss = 0.5f * (svm->w1 * svm->w1 + svm->w2 * svm->w2);
-    for (int i = 0; i < ds->count; i++) {
+// Norm of the (sub)gradient of the loss at the current parameters.
+float compute_gradient_norm(const Dataset *ds, const SVM *svm) {
+    if (ds->count == 0) return 0.0f;
+    float g1 = 0, g2 = 0, gb = 0;
+    for (size_t i = 0; i < ds->count; i++) {
         Sample s = ds->items[i];
         float margin = s.class * (svm->w1 * s.x + svm->w2 * s.z + svm->b);
-        float hinge = 1.0f - margin;
-        if (hinge > 0) loss += hinge;
+        if (margin < 1.0f) {
+            g1 -= s.class * s.x;
+            g2 -= s.class * s.z;
+            gb -= s.class;
+        }
     }
-    return loss / ds->count;
+    g1 = g1 / ds->count + lambda * svm->w1;
+    g2 = g2 / ds->count + lambda * svm->w2;
+    gb = gb / ds->count;
+    return sqrtf(g1 * g1 + g2 * g2 + gb * gb);
+}
+
+// Exact minimizer of SvmStats.loss: the soft-margin dual with a linear
+// kernel and C = 1, solved by SMO in one go.
+typedef struct {
+    bool done;
+    bool converged;
+    long long iters;
+    int support;
+    int bounded;
+    double ms;
+} SolveStats;
+
+SolveStats solve_stats = {0};
+
+void solve_svm(const Dataset *ds, SVM *svm) {
+    int n = (int)ds->count;
+    if (n == 0) return;
+    float *X = malloc(sizeof(float) * n * 2);
+    int *y = malloc(sizeof(int) * n);
+    for (int i = 0; i < n; i++) {
+        X[i * 2 + 0] = ds->items[i].x;
+        X[i * 2 + 1] = ds->items[i].z;
+        y[i] = ds->items[i].class;
+    }
+
+    double t0 = GetTime();
+    SmoSolver s;
+    smo_init(&s, X, y, n, 2, (Kernel){.kind = KERNEL_LINEAR}, 1.0);
+    smo_run(&s, 0);
+
+    float w[2];
+    smo_linear_weights(&s, w);
+    svm->w1 = w[0];
+    svm->w2 = w[1];
+    svm->b = (float)s.b;
+
+    solve_stats = (SolveStats){
+        .done = true,
+        .converged = s.converged,
+        .iters = s.iter,
+        .ms = (GetTime() - t0) * 1000.0,
+    };
+    solve_stats.support = smo_support_count(&s, &solve_stats.bounded);
+    smo_free(&s);
+    free(X);
+    free(y);
 }
 
+// ── Multiclass ──────────────────────────────────────────────
+
+// All three species on (x, z), one binary model per class (or per pair),
+// trained side by side on the pool. Model classes are IRIS_LABEL - 1.
+#define MULTI_GRID   40
+#define MULTI_EXTENT 5.0f
+
+ThreadPool pool;
+MultiSvm multi = {0};
+bool multi_on = false;
+float multi_acc = 0;
+double multi_ms = 0;
+int multi_grid[MULTI_GRID * MULTI_GRID];
+
+void multi_fit(Dataset *ds, MultiMode mode) {
+    int n = (int)ds->count;
+    float *X = malloc(sizeof(float) * 2 * (n > 0 ? n : 1));
+    int *labels = malloc(sizeof(int) * (n > 0 ? n : 1));
+    int *pred = malloc(sizeof(int) * (n > 0 ? n : 1));
+    for (int i = 0; i < n; i++) {
+        X[2 * i] = ds->items[i].x;
+        X[2 * i + 1] = ds->items[i].z;
+        labels[i] = ds->items[i].label - 1;
+    }
+
+    multi_free(&multi);
+    multi_init(&multi, mode, CLASS_COUNT - 1, 2, DCD_L1_LOSS, 1.0);
+    double t0 = GetTime();
+    multi_train(&multi, X, labels, n, &pool);
+    multi_ms = (GetTime() - t0) * 1000.0;
+    multi_acc = n ? (float)multi_predict_batch(&multi, X, n, pred, labels) / n : 0.0f;
+
+    for (int i = 0; i < n; i++)
+        tween_color(&te, &ds->vis[i].color, FEATURES_COLORS[pred[i] + 1], 0.6f);
+
+    float grid_pts[MULTI_GRID * MULTI_GRID * 2];
+    float cell = 2.0f * MULTI_EXTENT / MULTI_GRID;
+    for (int iz = 0; iz < MULTI_GRID; iz++) {
+        for (int ix = 0; ix < MULTI_GRID; ix++) {
+            grid_pts[2 * (iz * MULTI_GRID + ix)] = -MULTI_EXTENT + (ix + 0.5f) * cell;
+            grid_pts[2 * (iz * MULTI_GRID + ix) + 1] = -MULTI_EXTENT + (iz + 0.5f) * cell;
+        }
+    }
+    multi_predict_batch(&multi, grid_pts, MULTI_GRID * MULTI_GRID, multi_grid, NULL);
+
+    multi_on = true;
+    free(X);
+    free(labels);
+    free(pred);
+}
+
+void multi_hide(Dataset *ds) {
+    multi_on = false;
+    for (size_t i = 0; i < ds->count; i++)
+        tween_color(&te, &ds->vis[i].color, FEATURES_COLORS[ds->items[i].label], 0.6f);
+}
+
+void draw_multi_regions(VIEW_MODE view_mode) {
+    if (!multi_on || view_mode != VIEW_2D) return;
+    float cell = 2.0f * MULTI_EXTENT / MULTI_GRID;
+    for (int iz = 0; iz < MULTI_GRID; iz++) {
+        for (int ix = 0; ix < MULTI_GRID; ix++) {
+            Color c = FEATURES_COLORS[multi_grid[iz * MULTI_GRID + ix] + 1];
+            c.a = 30;
+            Vector3 center = {-MULTI_EXTENT + (ix + 0.5f) * cell, -0.01f,
+                              -MULTI_EXTENT + (iz + 0.5f) * cell};
+            DrawPlane(center, (Vector2){cell, cell}, c);
+        }
+    }
+}
+
+// ── Hyperparameter search ───────────────────────────────────
+
+// [H] trains train()'s rule for a grid of (lr, lambda, epochs) plus
+// SEARCH_RANDOM log-uniform draws, one pool task per config, on the
+// current (x, z) features with every SEARCH_HOLDOUT-th sample held out.
+// The ranked table goes to stdout and the HUD; the winner's weights, lr
+// and lambda replace the current ones.
+#define SEARCH_RANDOM  16
+#define SEARCH_HOLDOUT 5
+#define SEARCH_SHOWN   5
+
+SearchConfigs search = {0};
+bool search_on = false;
+double search_ms = 0;
+
+void print_search(const SearchConfigs *cs) {
+    printf("%4s %-6s %10s %10s %7s %9s %9s %10s %10s %8s\n", "rank", "source", "lr", "lambda",
+           "epochs", "train", "val", "val hinge", "val margin", "ms");
+    for (size_t k = 0; k < cs->count; k++) {
+        const SearchConfig *c = &cs->items[k];
+        printf("%4zu %-6s %10.2e %10.2e %7d %8.1f%% %8.1f%% %10.4f %10.4f %8.2f\n", k + 1,
+               c->random ? "random" : "grid", c->lr, c->lambda, c->epochs, 100 * c->train_acc,
+               100 * c->val_acc, c->val_hinge, c->val_margin, c->ms);
+    }
+}
+
+void run_search(const Dataset *ds, SVM *svm) {
+    int n = (int)ds->count;
+    if (n == 0) return;
+    float *X = malloc(sizeof(float) * 2 * n);
+    int *y = malloc(sizeof(int) * n);
+    for (int i = 0; i < n; i++) {
+        X[2 * i] = ds->items[i].x;
+        X[2 * i + 1] = ds->items[i].z;
+        y[i] = ds->items[i].class;
+    }
+
+    static const float lrs[] = {1e-4f, 1e-3f, 1e-2f, 1e-1f};
+    static const float lambdas[] = {1e-3f, 1e-2f, 1e-1f, 1.0f};
+    static const int epochs[] = {10, 100, 1000};
+    search.count = 0;
+    search_grid(&search, lrs, 4, lambdas, 4, epochs, 3);
+    search_random(&search, SEARCH_RANDOM, 1e-4f, 1e-1f, 1e-3f, 1.0f, 10, 1000, (uint32_t)rand());
+
+    double t0 = GetTime();
+    search_run(&search, X, y, n, 2, SEARCH_HOLDOUT, &pool);
+    search_ms = (GetTime() - t0) * 1000.0;
+    printf("search: %zu configs on %d threads in %.1f ms\n", search.count, pool.num_threads,
+           search_ms);
+    print_search(&search);
+
+    const SearchConfig *best = &search.items[0];
+    svm->w1 = best->w[0];
+    svm->w2 = best->w[1];
+    svm->b = best->b;
+    lr = best->lr;
+    lambda = best->lambda;
+    search_on = true;
+    free(X);
+    free(y);
+}
+
+void draw_search(void) {
+    if (!search_on) return;
+    int x = WIDTH - 560, y = 100, lh = 22;
+    DrawText(TextFormat("SEARCH: %zu configs on %d threads, %.1f ms", search.count,
+                pool.num_threads, search_ms), x, y, 20, COLOR_GREEN);
+    DrawText("#  source        lr    lambda  epochs  val acc  hinge  margin", x, y + lh, 18, GRAY);
+    for (int k = 0; k < SEARCH_SHOWN && k < (int)search.count; k++) {
+        const SearchConfig *c = &search.items[k];
+        DrawText(TextFormat("%d  %-6s  %.1e  %.1e  %6d  %6.1f%%  %.3f  %.3f", k + 1,
+                    c->random ? "random" : "grid", c->lr, c->lambda, c->epochs,
+                    100 * c->val_acc, c->val_hinge, c->val_margin),
+                x, y + lh * (k + 2), 18, k == 0 ? COLOR_GREEN : GRAY);
+    }
+}
 
-Dataset dataset = {0};
 Dataset training_set = {0};
 BoundingBox ground = { (Vector3){ -100, 0, -100 }, (Vector3){100, 0, 100} };
 Camera camera = { 0 };
 SVM svm = {0};
+ConvergeMonitor monitor;
+
+// compute_stats() is rerun only when the parameters or the sample count
+// differ from the ones it last saw.
+SvmStats stats = {0};
+SVM stats_svm = {0};
+size_t stats_count = 0;
+bool stats_valid = false;
+
+const SvmStats *current_stats(const Dataset *ds, const SVM *svm) {
+    if (!stats_valid || stats_count != ds->count || stats_svm.w1 != svm->w1 ||
+        stats_svm.w2 != svm->w2 || stats_svm.b != svm->b) {
+        stats = compute_stats(ds, svm);
+        stats_svm = *svm;
+        stats_count = ds->count;
+        stats_valid = true;
+    }
+    return &stats;
+}
+
+// ── Incremental updates ─────────────────────────────────────
+
+// User points ([LMB] in 2D adds class +1, [Shift+LMB] class -1) are
+// appended to training_set, so every trainer, the HUD stats and the
+// convergence monitor see them. A new point does not restart training:
+// incremental.h warm-starts the current SVM and runs INCR_EPOCHS epochs of
+// train()'s rule over only the samples near the margin, at
+// O(INCR_EPOCHS x affected) instead of O(INCR_EPOCHS x n). It reads a
+// row-major copy of training_set's (x, z), which only grows at the end.
+#define INCR_EPOCHS 200
+#define INCR_SLACK  0.5f
+
+typedef struct {
+    int added;
+    int affected;           // samples visited per epoch by the last update
+    int total;
+    int rescans;            // full scans during the last update
+    double us;
+} IncrStats;
+
+IncrSvm incr = {0};
+float *incr_X = NULL;
+int *incr_y = NULL;
+size_t incr_n = 0;          // rows copied into incr_X
+size_t incr_cap = 0;
+IncrStats incr_stats = {0};
+
+// Warm-started update after rows were appended to `ds`.
+void incremental_update(const Dataset *ds, SVM *svm) {
+    double t0 = GetTime();
+    if (!incr.w_scan) incr_init(&incr, 2, INCR_EPOCHS, INCR_SLACK);
+    if (incr_cap < ds->count) {
+        incr_cap = ds->capacity;
+        incr_X = realloc(incr_X, sizeof(float) * 2 * incr_cap);
+        incr_y = realloc(incr_y, sizeof(int) * incr_cap);
+    }
+    for (; incr_n < ds->count; incr_n++) {
+        incr_X[2 * incr_n] = ds->items[incr_n].x;
+        incr_X[2 * incr_n + 1] = ds->items[incr_n].z;
+        incr_y[incr_n] = ds->items[incr_n].class;
+    }
+
+    float w[2] = {svm->w1, svm->w2};
+    incr_update(&incr, incr_X, incr_y, (int)ds->count, w, &svm->b, lr, lambda);
+    svm->w1 = w[0];
+    svm->w2 = w[1];
+
+    incr_stats = (IncrStats){
+        .added = incr_stats.added + 1,
+        .affected = incr.count,
+        .total = (int)ds->count,
+        .rescans = incr.rescans,
+        .us = (GetTime() - t0) * 1e6,
+    };
+}
+
+// Refused once training_set is full: growing it would move vis while the
+// radius, color and view tweens still point into it.
+void add_user_point(SVM *svm, Vector3 p, int class) {
+    if (training_set.count == training_set.capacity) return;
+    IRIS_LABEL label = class > 0 ? SETOSA : VERSICOLOR;
+    Sample sample = {.x = p.x, .z = p.z, .class = class, .label = label};
+    Visual vis = {.pos = {p.x, 0, p.z}, .radius = 0, .color = FEATURES_COLORS[label], .y = 0,
+                  .user = true};
+    dataset_append(&training_set, sample, vis);
+    tween_float(&te, &training_set.vis[training_set.count - 1].radius, POINT_RADIUS * 1.5f, 0.5f);
+    incremental_update(&training_set, svm);
+    if (multi_on) multi_fit(&training_set, multi.mode);
+}
 
 void update_frame(){
         float dt = GetFrameTime(); 
@@ -493,20 +975,60 @@ void update_frame(){
         if (IsKeyPressed(KEY_T))
             toggle_view_anim(&training_set, &camera, &view_mode);
 
-        if (IsKeyPressed(KEY_Q))
+        if (IsKeyPressed(KEY_Q)) {
             is_training = !is_training;
-        if (IsKeyPressed(KEY_I))
+            converge_resume(&monitor);
+        }
+        if (IsKeyPressed(KEY_I)) {
             svm_icr_w2(&svm, IsKeyDown(KEY_LEFT_SHIFT) ? -delta : delta);
-        if (IsKeyPressed(KEY_O))
+            converge_resume(&monitor);
+        }
+        if (IsKeyPressed(KEY_O)) {
             svm_icr_w1(&svm, IsKeyDown(KEY_LEFT_SHIFT) ? -delta : delta);
-        if (IsKeyPressed(KEY_P))
+            converge_resume(&monitor);
+        }
+        if (IsKeyPressed(KEY_P)) {
             svm_icr_b(&svm, IsKeyDown(KEY_LEFT_SHIFT) ? -delta : delta);
+            converge_resume(&monitor);
+        }
+        if (IsKeyPressed(KEY_M)) {
+            solve_svm(&training_set, &svm);
+            is_training = false;
+        }
+        if (IsKeyPressed(KEY_G)) {
+            use_pegasos = !use_pegasos;
+            pegasos_reset(&training_set);
+            converge_resume(&monitor);
+        }
+        if (IsKeyPressed(KEY_H)) {
+            run_search(&training_set, &svm);
+            is_training = false;
+            converge_resume(&monitor);
+        }
+        if (view_mode == VIEW_2D && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+            Ray ray = GetMouseRay(GetMousePosition(), camera);
+            RayCollision hit = GetRayCollisionBox(ray, ground);
+            if (hit.hit)
+                add_user_point(&svm, hit.point, IsKeyDown(KEY_LEFT_SHIFT) ? -1 : 1);
+        }
+        // off -> one-vs-rest -> one-vs-one -> off
+        if (IsKeyPressed(KEY_C)) {
+            if (!multi_on) multi_fit(&training_set, MULTI_OVR);
+            else if (multi.mode == MULTI_OVR) multi_fit(&training_set, MULTI_OVO);
+            else multi_hide(&training_set);
+        }
 
-        if (is_training)
-            train(&training_set, &svm);
+        // Parked once the monitor calls it; any parameter change resumes
+        bool trained = is_training && monitor.state == CONV_RUNNING;
+        if (trained) {
+            if (use_pegasos) train_pegasos(&training_set, &svm);
+            else train(&training_set, &svm);
+        }
+
+        const SvmStats *st = current_stats(&training_set, &svm);
 
-        float loss = compute_loss(&training_set, &svm);
-        float acc = compute_accuracy(&training_set, &svm);
+        if (trained && converge_push(&monitor, st->loss))
+            converge_check(&monitor, compute_gradient_norm(&training_set, &svm));
 
         float smooth = 8.0f * dt;
         svm_visual.w1 = lerpf(svm_visual.w1, svm.w1, smooth);
@@ -521,17 +1043,47 @@ void update_frame(){
                 if(view_mode == VIEW_2D)
                     DrawGrid(10, 1);
                 draw_axes(view_mode);
+                draw_multi_regions(view_mode);
                 draw_dataset(&training_set, dt, true);
-                draw_dataset(&dataset, dt, false);
                 draw_svm(&svm_visual, view_mode);
             EndMode3D();
 
-            DrawText(TextFormat("LR: %.5f | W1: %.3f W2: %.3f B: %.3f | Loss: %.4f | Acc: %.1f%%",
-                        lr, svm.w1, svm.w2, svm.b, loss, acc * 100.0f), 20, HEIGHT - 30, 20, GRAY);
-
-            DrawText(is_training ? "TRAINING..." : "PAUSED [Q to train]", 20, HEIGHT - 55, 20, 
-                    is_training ? COLOR_GREEN : COLOR_RED);
-            DrawText("[T] Toggle view  [I/O/P] +w2/w1/b  [Shift+I/O/P] -w2/w1/b", 20, 20, 18, GRAY);
+            const char *trainer = use_pegasos
+                ? TextFormat("PEGASOS batch %d, step %lld", pegasos.batch, pegasos.t)
+                : TextFormat("LR: %.5f lambda: %.3g", lr, lambda);
+            DrawText(TextFormat("%s | W1: %.3f W2: %.3f B: %.3f | Loss: %.4f | Acc: %.1f%%",
+                        trainer, svm.w1, svm.w2, svm.b, st->loss, st->accuracy * 100.0f), 20, HEIGHT - 30, 20, GRAY);
+            DrawText(TextFormat("Min margin: %.3f | Inside margin: %d | Misclassified: %d",
+                        st->min_margin, st->inside_margin, st->misclassified), 20, HEIGHT - 130, 20, GRAY);
+
+            if (is_training && monitor.state != CONV_RUNNING)
+                DrawText(TextFormat("PARKED: %s (slope %.2e, |grad| %.2e) [I/O/P/Q resume]",
+                            CONVERGE_STATE_NAMES[monitor.state], monitor.slope, monitor.grad_norm),
+                        20, HEIGHT - 55, 20, COLOR_BLUE);
+            else
+                DrawText(is_training ? "TRAINING..." : "PAUSED [Q to train]", 20, HEIGHT - 55, 20, 
+                        is_training ? COLOR_GREEN : COLOR_RED);
+            if (multi_on)
+                DrawText(TextFormat("MULTICLASS %s: %d models on %d threads, %.2f ms | Acc: %.1f%%",
+                            MULTI_MODE_NAMES[multi.mode], multi.models, pool.num_threads,
+                            multi_ms, multi_acc * 100.0f),
+                        20, HEIGHT - 105, 20, COLOR_GREEN);
+            if (solve_stats.done)
+                DrawText(TextFormat("SMO: %s in %lld iterations, %.2f ms | %d support vectors (%d at C)",
+                            solve_stats.converged ? "optimal" : "stopped", solve_stats.iters,
+                            solve_stats.ms, solve_stats.support, solve_stats.bounded),
+                        20, HEIGHT - 80, 20, COLOR_BLUE);
+            draw_search();
+            if (incr_stats.added)
+                DrawText(TextFormat("INCREMENTAL: %d user points%s | last update visited %d of %d samples, %d full scans, %.0f us",
+                            incr_stats.added,
+                            training_set.count == training_set.capacity ? " (full)" : "",
+                            incr_stats.affected, incr_stats.total,
+                            incr_stats.rescans, incr_stats.us),
+                        20, HEIGHT - 155, 20, COLOR_BLUE);
+            if (view_mode == VIEW_2D)
+                DrawCircleLinesV(GetMousePosition(), 6, RAYWHITE);
+            DrawText("[T] Toggle view  [I/O/P] +w2/w1/b  [Shift+I/O/P] -w2/w1/b  [M] Solve (SMO)  [C] Multiclass  [G] Pegasos  [H] Search  [LMB/Shift+LMB] Add +1/-1 point (2D)", 20, 20, 18, GRAY);
                 draw_axis_labels(&camera, view_mode);
                 
                 draw_classes();
@@ -545,7 +1097,12 @@ int main()
 
     da_reserve(&te, 1024);
 
+    // Room for the user points too; add_user_point() stops at this capacity
+    // so tweens never see a realloc
+    da_reserve(&training_set, IRIS.count + POINT_COUNT);
     prepare_training_dataset(&training_set);
+    pool_init(&pool, pool_default_threads());
+    converge_init(&monitor, 2e-3f, 1e-6f, 1e-3f);
 
     camera.position = (Vector3){ -10.0f, 0.0f, 0.5f };
     camera.target = (Vector3){ 0.0f, -1.0f, 1.0f };
@@ -567,6 +1124,15 @@ int main()
         update_frame();
     }
 #endif
+    unload_planes();
     CloseWindow();
+    dataset_free(&training_set);
+    multi_free(&multi);
+    pegasos_free(&pegasos);
+    da_free(search);
+    incr_free(&incr);
+    free(incr_X);
+    free(incr_y);
+    pool_free(&pool);
     return 0;
 }
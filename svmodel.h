@@ -0,0 +1,153 @@
+#ifndef SVMODEL_H
+#define SVMODEL_H
+
+// Compact prediction model extracted from a trained SmoSolver. Include
+// kernel.h and smo.h first.
+//
+// smo_decision() computes a kernel row against all n training points and
+// then skips the ones with alpha = 0. svmodel_compact() copies only the
+// support vectors into one 16-byte aligned, column-major block, with their
+// coefficients alpha_i y_i and squared norms next to them. A linear kernel
+// goes further and collapses everything into one weight vector.
+//
+// For RBF the squared distance comes from the norms, |x|^2 - 2 x.v + |v|^2,
+// so scoring a row is one dot product per vector plus exp. The batch path
+// walks the vectors in tiles of SVMODEL_TILE and scores every query row
+// against a tile before moving on, so the tile stays in L1 while the rows
+// stream past.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SVMODEL_TILE 256
+
+typedef struct {
+    Kernel kernel;
+    int dim;
+    int count;              // support vectors
+    int cap;                // count rounded up to 4
+    float *sv;              // dim columns of cap values, aligned
+    float *coef;            // alpha_i y_i, 0 in the padding
+    float *norms;           // |v_i|^2
+    float *w;               // dim weights, linear kernel only
+    float b;
+    bool linear;
+} SvModel;
+
+float *svmodel_alloc(size_t count) {
+    size_t bytes = (count * sizeof(float) + 15) & ~(size_t)15;
+    float *p = aligned_alloc(16, bytes ? bytes : 16);
+    memset(p, 0, bytes);
+    return p;
+}
+
+void svmodel_compact(SvModel *m, const SmoSolver *s) {
+    *m = (SvModel){0};
+    m->kernel = s->kernel;
+    m->dim = s->dim;
+    m->b = (float)s->b;
+    m->count = smo_support_count(s, NULL);
+    m->linear = s->kernel.kind == KERNEL_LINEAR;
+
+    if (m->linear) {
+        m->w = svmodel_alloc(s->dim);
+        smo_linear_weights(s, m->w);
+        return;
+    }
+
+    m->cap = (m->count + 3) & ~3;
+    m->sv = svmodel_alloc((size_t)m->dim * m->cap);
+    m->coef = svmodel_alloc(m->cap);
+    m->norms = svmodel_alloc(m->cap);
+    int k = 0;
+    for (int t = 0; t < s->n; t++) {
+        if (s->alpha[t] <= 0) continue;
+        float sq = 0;
+        for (int d = 0; d < m->dim; d++) {
+            float v = s->cols[(size_t)d * s->cap + t];
+            m->sv[(size_t)d * m->cap + k] = v;
+            sq += v * v;
+        }
+        m->coef[k] = (float)(s->alpha[t] * s->y[t]);
+        m->norms[k++] = sq;
+    }
+}
+
+void svmodel_free(SvModel *m) {
+    free(m->sv);
+    free(m->coef);
+    free(m->norms);
+    free(m->w);
+    *m = (SvModel){0};
+}
+
+size_t svmodel_bytes(const SvModel *m) {
+    if (m->linear) return sizeof(float) * (m->dim + 1);
+    return sizeof(float) * ((size_t)m->dim * m->cap + 2 * (size_t)m->cap + 1);
+}
+
+// Adds sum_{j in [begin, end)} coef_j K(x, v_j) to out[i] for each row of X.
+void svmodel_tile(const SvModel *m, const float *X, int n, int begin, int end, float *out) {
+    const Kernel *k = &m->kernel;
+    for (int i = 0; i < n; i++) {
+        const float *x = X + (size_t)i * m->dim;
+        float xx = 0;
+        for (int d = 0; d < m->dim; d++) xx += x[d] * x[d];
+        int j = begin;
+        float sum = 0;
+#if defined(__SSE2__)
+        __m128 acc = _mm_setzero_ps();
+        __m128 gamma = _mm_set1_ps(k->gamma);
+        for (; j + 4 <= end; j += 4) {
+            __m128 dot = _mm_setzero_ps();
+            for (int d = 0; d < m->dim; d++)
+                dot = _mm_add_ps(dot, _mm_mul_ps(_mm_set1_ps(x[d]),
+                                                 _mm_load_ps(m->sv + (size_t)d * m->cap + j)));
+            __m128 kv;
+            if (k->kind == KERNEL_RBF) {
+                __m128 d2 = _mm_sub_ps(_mm_add_ps(_mm_set1_ps(xx), _mm_load_ps(m->norms + j)),
+                                       _mm_add_ps(dot, dot));
+                d2 = _mm_max_ps(d2, _mm_setzero_ps());
+                kv = exp_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(gamma, d2)));
+            } else {
+                __m128 base = _mm_add_ps(_mm_mul_ps(gamma, dot), _mm_set1_ps(k->coef0));
+                kv = _mm_set1_ps(1.0f);
+                for (int p = 0; p < k->degree; p++) kv = _mm_mul_ps(kv, base);
+            }
+            acc = _mm_add_ps(acc, _mm_mul_ps(kv, _mm_load_ps(m->coef + j)));
+        }
+        sum = hsum_ps(acc);
+#endif
+        for (; j < end; j++)
+            sum += m->coef[j] * kernel_eval_strided(k, x, m->sv + j, m->cap, m->dim);
+        out[i] += sum;
+    }
+}
+
+// Decision values for n row-major inputs.
+void svmodel_predict_batch(const SvModel *m, const float *X, int n, float *out) {
+    if (m->linear) {
+        for (int i = 0; i < n; i++) {
+            const float *x = X + (size_t)i * m->dim;
+            float f = m->b;
+            for (int d = 0; d < m->dim; d++) f += m->w[d] * x[d];
+            out[i] = f;
+        }
+        return;
+    }
+    for (int i = 0; i < n; i++) out[i] = m->b;
+    // The padding has coef 0, so the last tile runs to cap and stays 4-wide
+    for (int begin = 0; begin < m->count; begin += SVMODEL_TILE) {
+        int end = begin + SVMODEL_TILE < m->cap ? begin + SVMODEL_TILE : m->cap;
+        svmodel_tile(m, X, n, begin, end, out);
+    }
+}
+
+float svmodel_decision(const SvModel *m, const float *x) {
+    float f;
+    svmodel_predict_batch(m, x, 1, &f);
+    return f;
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+// Compact per-epoch log of a perceptron's weights and bias. Include nob.h
+// first.
+//
+// Floats are mapped to order-preserving uint32 so neighbouring values have
+// neighbouring codes. Each snapshot stores the zigzagged difference to the
+// previous one, bit-packed at the smallest width that fits all of its
+// values (a 6-bit width header, then dim values). Late in training weights
+// move by a few ulps per epoch, so a snapshot costs a few bytes. The log is
+// lossless.
+//
+// Every TRAJ_KEYFRAME_INTERVAL snapshots a raw keyframe is kept, together
+// with its bit offset, so any snapshot is restored from the keyframe before
+// it plus fewer than TRAJ_KEYFRAME_INTERVAL delta decodes.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define TRAJ_KEYFRAME_INTERVAL 256
+#define TRAJ_WIDTH_BITS        6
+
+typedef struct {
+    uint64_t *items;
+    size_t count;
+    size_t capacity;
+} TrajWords;
+
+typedef struct {
+    float *items;
+    size_t count;
+    size_t capacity;
+} TrajKeyValues;
+
+typedef struct {
+    size_t *items;
+    size_t count;
+    size_t capacity;
+} TrajKeyOffsets;
+
+typedef struct {
+    int dim;                // values per snapshot: weights, then bias
+    long long count;        // snapshots recorded
+    size_t max_bytes;       // recording stops once the log reaches this size
+    bool full;
+
+    TrajWords bits;
+    size_t bit_len;
+    TrajKeyValues keys;     // dim raw values per keyframe
+    TrajKeyOffsets key_pos; // bit offset of the first delta after each keyframe
+
+    uint32_t *prev;         // last recorded snapshot, ordered codes
+    uint32_t *scratch;      // deltas in traj_record(), codes in traj_restore()
+} Trajectory;
+
+uint32_t traj_encode_float(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return (u & 0x80000000u) ? ~u : u | 0x80000000u;
+}
+
+float traj_decode_float(uint32_t u) {
+    u = (u & 0x80000000u) ? u & 0x7fffffffu : ~u;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+void traj_put_bits(Trajectory *t, uint64_t v, int width) {
+    if (width == 0) return;
+    size_t word = t->bit_len >> 6;
+    int off = t->bit_len & 63;
+    while (t->bits.count < word + 2) da_append(&t->bits, 0);
+    t->bits.items[word] |= v << off;
+    if (off + width > 64) t->bits.items[word + 1] |= v >> (64 - off);
+    t->bit_len += width;
+}
+
+uint32_t traj_get_bits(const Trajectory *t, size_t *pos, int width) {
+    if (width == 0) return 0;
+    size_t word = *pos >> 6;
+    int off = *pos & 63;
+    uint64_t v = t->bits.items[word] >> off;
+    if (off + width > 64) v |= t->bits.items[word + 1] << (64 - off);
+    *pos += width;
+    return (uint32_t)(v & ((1ull << width) - 1));
+}
+
+void traj_clear(Trajectory *t) {
+    t->count = 0;
+    t->full = false;
+    t->bits.count = 0;
+    t->bit_len = 0;
+    t->keys.count = 0;
+    t->key_pos.count = 0;
+}
+
+void traj_init(Trajectory *t, int dim, size_t max_bytes) {
+    t->dim = dim;
+    t->max_bytes = max_bytes;
+    t->prev = realloc(t->prev, sizeof(uint32_t) * dim);
+    t->scratch = realloc(t->scratch, sizeof(uint32_t) * dim);
+    traj_clear(t);
+}
+
+void traj_free(Trajectory *t) {
+    da_free(t->bits);
+    da_free(t->keys);
+    da_free(t->key_pos);
+    free(t->prev);
+    free(t->scratch);
+    *t = (Trajectory){0};
+}
+
+size_t traj_bytes(const Trajectory *t) {
+    return t->bits.count * sizeof(uint64_t) + t->keys.count * sizeof(float) +
+           t->key_pos.count * sizeof(size_t);
+}
+
+// Appends one snapshot. Returns false once the log is full.
+bool traj_record(Trajectory *t, const float *w, float b) {
+    if (t->full || traj_bytes(t) >= t->max_bytes) {
+        t->full = true;
+        return false;
+    }
+    int n = t->dim - 1;
+
+    if (t->count % TRAJ_KEYFRAME_INTERVAL == 0) {
+        for (int j = 0; j < n; j++) da_append(&t->keys, w[j]);
+        da_append(&t->keys, b);
+        da_append(&t->key_pos, t->bit_len);
+        for (int j = 0; j < n; j++) t->prev[j] = traj_encode_float(w[j]);
+        t->prev[n] = traj_encode_float(b);
+        t->count++;
+        return true;
+    }
+
+    // Zigzag of the wrapping difference, so both directions pack small
+    uint32_t *zz = t->scratch;
+    uint32_t all = 0;
+    for (int j = 0; j < t->dim; j++) {
+        uint32_t cur = traj_encode_float(j < n ? w[j] : b);
+        int32_t d = (int32_t)(cur - t->prev[j]);
+        zz[j] = ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+        all |= zz[j];
+        t->prev[j] = cur;
+    }
+    int width = 0;
+    while (width < 32 && (all >> width) != 0) width++;
+
+    traj_put_bits(t, width, TRAJ_WIDTH_BITS);
+    for (int j = 0; j < t->dim; j++) traj_put_bits(t, zz[j], width);
+    t->count++;
+    return true;
+}
+
+// Writes snapshot `index` into w and b. Returns false if it was not recorded.
+bool traj_restore(Trajectory *t, long long index, float *w, float *b) {
+    if (index < 0 || index >= t->count) return false;
+    int n = t->dim - 1;
+    size_t k = (size_t)(index / TRAJ_KEYFRAME_INTERVAL);
+    const float *key = t->keys.items + k * t->dim;
+    for (int j = 0; j < t->dim; j++) t->scratch[j] = traj_encode_float(key[j]);
+
+    size_t pos = t->key_pos.items[k];
+    for (long long s = 0; s < index % TRAJ_KEYFRAME_INTERVAL; s++) {
+        int width = (int)traj_get_bits(t, &pos, TRAJ_WIDTH_BITS);
+        for (int j = 0; j < t->dim; j++) {
+            uint32_t zz = traj_get_bits(t, &pos, width);
+            t->scratch[j] += (zz >> 1) ^ (0u - (zz & 1));
+        }
+    }
+
+    for (int j = 0; j < n; j++) w[j] = traj_decode_float(t->scratch[j]);
+    *b = traj_decode_float(t->scratch[n]);
+    return true;
+}
+
+#endif
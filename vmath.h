@@ -0,0 +1,63 @@
+#ifndef VMATH_H
+#define VMATH_H
+
+// SSE2 helpers shared by the batch scoring paths. Everything here is only
+// defined when __SSE2__ is; callers keep a scalar fallback.
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+// expf for 4 lanes: range reduction to 2^k * e^r and a degree-5 polynomial
+// for e^r (Cephes), within a couple of ulps of expf on the clamped range.
+__m128 exp_ps(__m128 x) {
+    x = _mm_min_ps(x, _mm_set1_ps(88.3762626647949f));
+    x = _mm_max_ps(x, _mm_set1_ps(-88.3762626647949f));
+
+    __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)), _mm_set1_ps(0.5f));
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+    fx = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, fx), _mm_set1_ps(1.0f)));  // floor
+
+    x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(0.693359375f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(-2.12194440e-4f)));
+    __m128 z = _mm_mul_ps(x, x);
+
+    __m128 y = _mm_set1_ps(1.9875691500e-4f);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507e-3f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073e-3f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894e-2f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201e-1f));
+    y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, z), x), _mm_set1_ps(1.0f));
+
+    __m128i k = _mm_add_epi32(_mm_cvttps_epi32(fx), _mm_set1_epi32(127));
+    return _mm_mul_ps(y, _mm_castsi128_ps(_mm_slli_epi32(k, 23)));
+}
+
+// cosf for 4 lanes: r = x - 2 pi k for the nearest k (two-part constant),
+// then cos r = 1 - 2 sin^2(r / 2) with the odd Taylor series of sin to
+// degree 11 on [-pi/2, pi/2]. Absolute error below 1e-6 for |x| < 2000.
+__m128 cos_ps(__m128 x) {
+    __m128 k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.15915494309189535f))));
+    x = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(6.28125f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(1.9353071795864769e-3f)));
+
+    __m128 u = _mm_mul_ps(x, _mm_set1_ps(0.5f));
+    __m128 u2 = _mm_mul_ps(u, u);
+    __m128 p = _mm_set1_ps(-2.5052108385441720e-8f);
+    p = _mm_add_ps(_mm_mul_ps(p, u2), _mm_set1_ps(2.7557319223985893e-6f));
+    p = _mm_add_ps(_mm_mul_ps(p, u2), _mm_set1_ps(-1.9841269841269841e-4f));
+    p = _mm_add_ps(_mm_mul_ps(p, u2), _mm_set1_ps(8.3333333333333333e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, u2), _mm_set1_ps(-1.6666666666666667e-1f));
+    __m128 sin_u = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, u2), u), u);
+    return _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(2.0f), _mm_mul_ps(sin_u, sin_u)));
+}
+
+// Sum of the four lanes.
+float hsum_ps(__m128 v) {
+    __m128 s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+}
+#endif
+
+#endif